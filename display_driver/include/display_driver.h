@@ -15,6 +15,8 @@
  *
  * @note
  * Typical usage sequence: init() -> set_up_*() -> ops_*() -> destroy().
+ * For several updates in a row wrap them in session_open() / session_close()
+ * so the panel is not powered on and put into deep sleep around each of them.
  * Always call destroy() to release resources.
  *
  * @warning
@@ -170,6 +172,32 @@ dd_error_t dd_display_driver_write(dd_display_driver_t dd, unsigned char *buf,
 
 void dd_display_driver_destroy(dd_display_driver_t *out);
 
+/**
+ * @brief Keep the panel powered between updates.
+ *
+ * Every update outside of a session powers the controller on, resets it and
+ * puts it back into deep sleep, which adds about a second of fixed delays.
+ * Inside a session the panel stays awake, so following updates of the same
+ * kind skip that sequence. Panels should not stay powered for long, so the
+ * session puts the panel into deep sleep after `idle_timeout_ms` without
+ * updates, next update wakes it up again.
+ *
+ * @param dd Driver instance.
+ * @param idle_timeout_ms Idle time before deep sleep, 0 keeps the panel awake
+ *                        until the session is closed.
+ * @return Error on failure, NULL on success.
+ */
+dd_error_t dd_display_driver_session_open(dd_display_driver_t dd,
+                                          int idle_timeout_ms);
+
+/**
+ * @brief Close session and put the panel into deep sleep.
+ * @param dd Driver instance.
+ * @return Error on failure, NULL on success. Failure of a deep sleep after
+ *         idle timeout is reported here as well.
+ */
+dd_error_t dd_display_driver_session_close(dd_display_driver_t dd);
+
 int dd_display_driver_get_x(dd_display_driver_t dd);
 int dd_display_driver_get_y(dd_display_driver_t dd);
 int dd_display_driver_get_stride(dd_display_driver_t dd);
@@ -179,4 +207,67 @@ dd_error_t dd_display_driver_write_partial(dd_display_driver_t dd,
 dd_error_t dd_display_driver_write_fast(dd_display_driver_t dd,
                                         unsigned char *buf, uint32_t buf_len);
 
+/******************************************************************
+ *                      Asynchronous Updates
+ ******************************************************************
+ */
+enum dd_DisplayDriverWriteEnum {
+  dd_DisplayDriverWriteEnum_FULL,    // dd_display_driver_write
+  dd_DisplayDriverWriteEnum_FAST,    // dd_display_driver_write_fast
+  dd_DisplayDriverWriteEnum_PARTIAL, // dd_display_driver_write_partial
+};
+
+/**
+ * @brief Update submitted to dd_display_driver_submit_async.
+ *        `x1`, `x2`, `y1` and `y2` are used only by partial updates.
+ */
+struct dd_DisplayDriverWrite {
+  enum dd_DisplayDriverWriteEnum type;
+  unsigned char *buf;
+  uint32_t buf_len;
+  int x1;
+  int x2;
+  int y1;
+  int y2;
+};
+
+/**
+ * @brief Called once submitted update is done.
+ * @param err Error if update failed, NULL on success. Valid only during the
+ *            call.
+ * @param data User data passed to dd_display_driver_submit_async.
+ */
+typedef void (*dd_display_driver_done_cb_t)(dd_error_t err, void *data);
+
+/**
+ * @brief Queue update and return without waiting for the panel.
+ *
+ * Updates run in submission order on a worker thread owned by the driver,
+ * `buf` is copied so it can be reused right after the call. `on_done` runs
+ * on the worker thread, updates still queued when the driver is destroyed
+ * are reported with ECANCELED from the destroying thread.
+ *
+ * @param dd Driver instance.
+ * @param write Update to display.
+ * @param on_done Completion callback, can be NULL.
+ * @param data User data passed to `on_done`.
+ * @return Error on failure, NULL on success.
+ */
+dd_error_t dd_display_driver_submit_async(dd_display_driver_t dd,
+                                          struct dd_DisplayDriverWrite *write,
+                                          dd_display_driver_done_cb_t on_done,
+                                          void *data);
+
+/**
+ * @brief Eventfd which becomes readable when submitted updates are done.
+ *
+ * Reading it returns number of updates finished since the last read, so it
+ * can be added to the app's poll loop instead of waking it from `on_done`.
+ * The fd is owned by the driver.
+ *
+ * @param dd Driver instance.
+ * @return File descriptor, -1 on error.
+ */
+int dd_display_driver_get_event_fd(dd_display_driver_t dd);
+
 #endif // DISPLAY_DRIVER_H
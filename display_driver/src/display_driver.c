@@ -24,8 +24,13 @@ dd_error_t dd_display_driver_init(dd_display_driver_t *out,
     break;
   }
 
+  dd_errno = dd_driver_init(*out);
+  DD_TRY_CATCH(dd_errno, error_driver_cleanup);
+
   return 0;
 
+error_driver_cleanup:
+  (*out)->destroy((*out)->driver_data);
 error_out_cleanup:
   dd_free(*out);
   *out = NULL;
@@ -80,6 +85,38 @@ error_out:
   return dd_errno;
 }
 
+dd_error_t dd_display_driver_session_open(dd_display_driver_t dd,
+                                          int idle_timeout_ms) {
+  if (!dd || idle_timeout_ms < 0) {
+    dd_errno = dd_errnos(
+        EINVAL, "`dd` cannot be NULL and `idle_timeout_ms` cannot be negative");
+    goto error_out;
+  }
+
+  dd_errno = dd_driver_session_open(dd, idle_timeout_ms);
+  DD_TRY(dd_errno);
+
+  return 0;
+
+error_out:
+  return dd_errno;
+}
+
+dd_error_t dd_display_driver_session_close(dd_display_driver_t dd) {
+  if (!dd) {
+    dd_errno = dd_errnos(EINVAL, "`dd` cannot be NULL");
+    goto error_out;
+  }
+
+  dd_errno = dd_driver_session_close(dd);
+  DD_TRY(dd_errno);
+
+  return 0;
+
+error_out:
+  return dd_errno;
+}
+
 int dd_display_driver_get_x(dd_display_driver_t dd) {
   if (!dd) {
     dd_errno = dd_errnos(EINVAL, "`dd` cannot be NULL");
@@ -148,3 +185,34 @@ dd_error_t dd_display_driver_write_fast(dd_display_driver_t dd,
 error_out:
   return dd_errno;
 }
+
+dd_error_t dd_display_driver_submit_async(dd_display_driver_t dd,
+                                          struct dd_DisplayDriverWrite *write,
+                                          dd_display_driver_done_cb_t on_done,
+                                          void *data) {
+  if (!dd || !write || !write->buf) {
+    dd_errno =
+        dd_errnos(EINVAL, "`dd`, `write` and `write->buf` cannot be NULL");
+    goto error_out;
+  }
+
+  dd_errno = dd_driver_submit(dd, write, on_done, data);
+  DD_TRY(dd_errno);
+
+  return 0;
+
+error_out:
+  return dd_errno;
+}
+
+int dd_display_driver_get_event_fd(dd_display_driver_t dd) {
+  if (!dd) {
+    dd_errno = dd_errnos(EINVAL, "`dd` cannot be NULL");
+    goto error_out;
+  }
+
+  return dd_driver_get_event_fd(dd);
+
+error_out:
+  return -1;
+}
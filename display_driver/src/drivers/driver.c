@@ -1,17 +1,84 @@
+#define _GNU_SOURCE
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/eventfd.h>
+#include <threads.h>
+#include <time.h>
+#include <unistd.h>
 
 #include "display_driver.h"
 #include "drivers/driver.h"
 #include "utils/err.h"
 #include "utils/mem.h"
 
+static dd_error_t dd_driver_update_done(dd_display_driver_t);
+static dd_error_t dd_driver_sleep(dd_display_driver_t);
+static int dd_driver_session_idle(void *);
+static void dd_driver_async_stop(dd_display_driver_t);
+static int dd_driver_async_worker(void *);
+
+dd_error_t dd_driver_init(dd_display_driver_t driver) {
+  struct dd_DriverSession *session = &driver->session;
+  *session = (struct dd_DriverSession){0};
+
+  if (mtx_init(&session->lock, mtx_plain) != thrd_success) {
+    dd_errno = dd_errnos(ENOMEM, "Cannot init session lock");
+    goto error_out;
+  }
+
+  if (cnd_init(&session->wake) != thrd_success) {
+    dd_errno = dd_errnos(ENOMEM, "Cannot init session condition");
+    goto error_lock_cleanup;
+  }
+
+  struct dd_DriverAsync *async = &driver->async;
+  *async = (struct dd_DriverAsync){0};
+
+  if (mtx_init(&async->lock, mtx_plain) != thrd_success) {
+    dd_errno = dd_errnos(ENOMEM, "Cannot init async lock");
+    goto error_wake_cleanup;
+  }
+
+  if (cnd_init(&async->wake) != thrd_success) {
+    dd_errno = dd_errnos(ENOMEM, "Cannot init async condition");
+    goto error_async_lock_cleanup;
+  }
+
+  async->event_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (async->event_fd < 0) {
+    dd_errno = dd_errnos(errno, "Cannot create async eventfd");
+    goto error_async_wake_cleanup;
+  }
+
+  return 0;
+
+error_async_wake_cleanup:
+  cnd_destroy(&async->wake);
+error_async_lock_cleanup:
+  mtx_destroy(&async->lock);
+error_wake_cleanup:
+  cnd_destroy(&session->wake);
+error_lock_cleanup:
+  mtx_destroy(&session->lock);
+error_out:
+  return dd_errno;
+}
+
 void dd_driver_destroy(dd_display_driver_t *out) {
   if (!out || !*out) {
     return;
   }
 
+  dd_driver_async_stop(*out);
+  close((*out)->async.event_fd);
+  cnd_destroy(&(*out)->async.wake);
+  mtx_destroy(&(*out)->async.lock);
+
+  dd_driver_session_close(*out);
+  cnd_destroy(&(*out)->session.wake);
+  mtx_destroy(&(*out)->session.lock);
+
   if ((*out)->destroy) {
     (*out)->destroy(((*out)->driver_data));
   }
@@ -28,7 +95,12 @@ dd_error_t dd_driver_write(dd_display_driver_t driver, unsigned char *buf,
     goto error_out;
   }
 
+  mtx_lock(&driver->session.lock);
   dd_errno = driver->write(driver->driver_data, buf, buf_len);
+  if (!dd_errno) {
+    dd_errno = dd_driver_update_done(driver);
+  }
+  mtx_unlock(&driver->session.lock);
   DD_TRY(dd_errno);
 
   return 0;
@@ -44,7 +116,12 @@ dd_error_t dd_driver_clear(dd_display_driver_t driver, bool white) {
     goto error_out;
   }
 
+  mtx_lock(&driver->session.lock);
   dd_errno = driver->clear(driver->driver_data, white);
+  if (!dd_errno) {
+    dd_errno = dd_driver_update_done(driver);
+  }
+  mtx_unlock(&driver->session.lock);
   DD_TRY(dd_errno);
 
   return 0;
@@ -67,8 +144,13 @@ dd_error_t dd_driver_write_part(dd_display_driver_t driver, unsigned char *buf,
     goto error_out;
   }
 
+  mtx_lock(&driver->session.lock);
   dd_errno =
       driver->write_part(driver->driver_data, buf, buf_len, x1, x2, y1, y2);
+  if (!dd_errno) {
+    dd_errno = dd_driver_update_done(driver);
+  }
+  mtx_unlock(&driver->session.lock);
   DD_TRY(dd_errno);
 
   return 0;
@@ -86,7 +168,109 @@ dd_error_t dd_driver_write_fast(dd_display_driver_t driver, unsigned char *buf,
     goto error_out;
   }
 
+  mtx_lock(&driver->session.lock);
   dd_errno = driver->write_fast(driver->driver_data, buf, buf_len);
+  if (!dd_errno) {
+    dd_errno = dd_driver_update_done(driver);
+  }
+  mtx_unlock(&driver->session.lock);
+  DD_TRY(dd_errno);
+
+  return 0;
+
+error_out:
+  return dd_errno;
+}
+
+dd_error_t dd_driver_session_open(dd_display_driver_t driver,
+                                  int idle_timeout_ms) {
+  struct dd_DriverSession *session = &driver->session;
+
+  mtx_lock(&session->lock);
+  if (session->is_open) {
+    dd_errno = dd_errnos(EBUSY, "Session is already open");
+    goto error_unlock;
+  }
+
+  session->is_open = true;
+  session->idle_timeout_ms = idle_timeout_ms;
+  if (idle_timeout_ms > 0 &&
+      thrd_create(&session->idle_thread, dd_driver_session_idle, driver) !=
+          thrd_success) {
+    session->is_open = false;
+    dd_errno = dd_errnos(ENOMEM, "Cannot start session idle thread");
+    goto error_unlock;
+  }
+  mtx_unlock(&session->lock);
+
+  return 0;
+
+error_unlock:
+  mtx_unlock(&session->lock);
+  return dd_errno;
+}
+
+dd_error_t dd_driver_session_close(dd_display_driver_t driver) {
+  struct dd_DriverSession *session = &driver->session;
+
+  mtx_lock(&session->lock);
+  if (!session->is_open) {
+    mtx_unlock(&session->lock);
+    return 0;
+  }
+  session->is_open = false;
+  cnd_signal(&session->wake);
+  mtx_unlock(&session->lock);
+
+  if (session->idle_timeout_ms > 0) {
+    thrd_join(session->idle_thread, NULL);
+  }
+
+  mtx_lock(&session->lock);
+  dd_errno = dd_driver_sleep(driver);
+  if (!dd_errno && session->has_idle_error) {
+    dd_errno = dd_error_copy(&dd_hidden_errno, &session->idle_error);
+  }
+  session->has_idle_error = false;
+  mtx_unlock(&session->lock);
+  DD_TRY(dd_errno);
+
+  return 0;
+
+error_out:
+  return dd_errno;
+}
+
+/**
+   Outside of session every update puts panel back into deep sleep, leaving
+   it powered for long can damage it.
+*/
+static dd_error_t dd_driver_update_done(dd_display_driver_t driver) {
+  struct dd_DriverSession *session = &driver->session;
+
+  session->is_awake = true;
+  if (!session->is_open) {
+    dd_errno = dd_driver_sleep(driver);
+    DD_TRY(dd_errno);
+    return 0;
+  }
+
+  timespec_get(&session->last_update, TIME_UTC);
+  cnd_signal(&session->wake);
+
+  return 0;
+
+error_out:
+  return dd_errno;
+}
+
+static dd_error_t dd_driver_sleep(dd_display_driver_t driver) {
+  if (!driver->session.is_awake || !driver->sleep) {
+    return 0;
+  }
+
+  driver->session.is_awake = false;
+  dd_errno = driver->sleep(driver->driver_data);
   DD_TRY(dd_errno);
 
   return 0;
@@ -94,3 +278,180 @@ dd_error_t dd_driver_write_fast(dd_display_driver_t driver, unsigned char *buf,
 error_out:
   return dd_errno;
 }
+
+static int dd_driver_session_idle(void *arg) {
+  dd_display_driver_t driver = arg;
+  struct dd_DriverSession *session = &driver->session;
+
+  mtx_lock(&session->lock);
+  while (session->is_open) {
+    if (!session->is_awake) {
+      cnd_wait(&session->wake, &session->lock);
+      continue;
+    }
+
+    struct timespec deadline = session->last_update;
+    deadline.tv_sec += session->idle_timeout_ms / 1000;
+    deadline.tv_nsec += (long)(session->idle_timeout_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+      deadline.tv_sec++;
+      deadline.tv_nsec -= 1000000000L;
+    }
+
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    if (now.tv_sec < deadline.tv_sec ||
+        (now.tv_sec == deadline.tv_sec && now.tv_nsec < deadline.tv_nsec)) {
+      // Wait for deadline, new update or session close
+      cnd_timedwait(&session->wake, &session->lock, &deadline);
+      continue;
+    }
+
+    // Idle thread has nobody to return the error to.
+    if (dd_driver_sleep(driver)) {
+      dd_error_copy(&session->idle_error, dd_errno);
+      session->has_idle_error = true;
+    }
+  }
+  mtx_unlock(&session->lock);
+
+  return 0;
+}
+
+dd_error_t dd_driver_submit(dd_display_driver_t driver,
+                            struct dd_DisplayDriverWrite *write,
+                            dd_display_driver_done_cb_t on_done, void *data) {
+  struct dd_DriverAsync *async = &driver->async;
+
+  struct dd_DriverJob *job = dd_malloc(sizeof(struct dd_DriverJob));
+  *job = (struct dd_DriverJob){
+      .write = *write,
+      .on_done = on_done,
+      .data = data,
+  };
+  job->write.buf = dd_malloc(write->buf_len);
+  memcpy(job->write.buf, write->buf, write->buf_len);
+
+  mtx_lock(&async->lock);
+  if (!async->is_running) {
+    if (thrd_create(&async->worker, dd_driver_async_worker, driver) !=
+        thrd_success) {
+      dd_errno = dd_errnos(ENOMEM, "Cannot start async worker");
+      goto error_job_cleanup;
+    }
+    async->is_running = true;
+  }
+
+  if (async->tail) {
+    async->tail->next = job;
+  } else {
+    async->head = job;
+  }
+  async->tail = job;
+  cnd_signal(&async->wake);
+  mtx_unlock(&async->lock);
+
+  return 0;
+
+error_job_cleanup:
+  mtx_unlock(&async->lock);
+  dd_free(job->write.buf);
+  dd_free(job);
+  return dd_errno;
+}
+
+int dd_driver_get_event_fd(dd_display_driver_t driver) {
+  return driver->async.event_fd;
+}
+
+static dd_error_t dd_driver_async_run(dd_display_driver_t driver,
+                                      struct dd_DisplayDriverWrite *write) {
+  switch (write->type) {
+  case dd_DisplayDriverWriteEnum_FULL:
+    dd_errno = dd_driver_write(driver, write->buf, write->buf_len);
+    break;
+  case dd_DisplayDriverWriteEnum_FAST:
+    dd_errno = dd_driver_write_fast(driver, write->buf, write->buf_len);
+    break;
+  case dd_DisplayDriverWriteEnum_PARTIAL:
+    dd_errno = dd_driver_write_part(driver, write->buf, write->buf_len,
+                                    write->x1, write->x2, write->y1, write->y2);
+    break;
+  default:
+    dd_errno = dd_errnos(EINVAL, "Unknown write type");
+    break;
+  }
+  DD_TRY(dd_errno);
+
+  return 0;
+
+error_out:
+  return dd_errno;
+}
+
+static void dd_driver_async_done(dd_display_driver_t driver,
+                                 struct dd_DriverJob *job, dd_error_t err) {
+  if (job->on_done) {
+    job->on_done(err, job->data);
+  }
+
+  dd_free(job->write.buf);
+  dd_free(job);
+
+  eventfd_write(driver->async.event_fd, 1);
+}
+
+static int dd_driver_async_worker(void *arg) {
+  dd_display_driver_t driver = arg;
+  struct dd_DriverAsync *async = &driver->async;
+
+  mtx_lock(&async->lock);
+  while (!async->is_stopping) {
+    struct dd_DriverJob *job = async->head;
+    if (!job) {
+      cnd_wait(&async->wake, &async->lock);
+      continue;
+    }
+
+    async->head = job->next;
+    if (!async->head) {
+      async->tail = NULL;
+    }
+    mtx_unlock(&async->lock);
+
+    dd_errno = dd_driver_async_run(driver, &job->write);
+    dd_driver_async_done(driver, job, dd_errno);
+
+    mtx_lock(&async->lock);
+  }
+  mtx_unlock(&async->lock);
+
+  return 0;
+}
+
+/**
+   Update in progress is finished, queued ones are cancelled so destroy does
+   not wait for several refreshes.
+*/
+static void dd_driver_async_stop(dd_display_driver_t driver) {
+  struct dd_DriverAsync *async = &driver->async;
+
+  mtx_lock(&async->lock);
+  struct dd_DriverJob *job = async->head;
+  async->head = async->tail = NULL;
+  async->is_stopping = true;
+  cnd_signal(&async->wake);
+  mtx_unlock(&async->lock);
+
+  while (job) {
+    struct dd_DriverJob *next = job->next;
+    dd_driver_async_done(driver, job,
+                         dd_errnos(ECANCELED, "Driver has been destroyed"));
+    job = next;
+  }
+
+  if (async->is_running) {
+    thrd_join(async->worker, NULL);
+    async->is_running = false;
+  }
+}
@@ -1,6 +1,50 @@
 #ifndef DISPLAY_DRIVER_DRIVER_H
 #define DISPLAY_DRIVER_DRIVER_H
+#include <stdbool.h>
+#include <threads.h>
+#include <time.h>
+
 #include "display_driver.h"
+#include "utils/err.h"
+
+/**
+   Session keeps panel awake between updates. Idle thread puts it into deep
+   sleep when there was no update for `idle_timeout_ms`. Error of that sleep
+   is kept in `idle_error` and returned by session close.
+*/
+struct dd_DriverSession {
+  mtx_t lock;
+  cnd_t wake;
+  thrd_t idle_thread;
+  struct timespec last_update;
+  int idle_timeout_ms;
+  bool is_open;
+  bool is_awake;
+  bool has_idle_error;
+  struct dd_Error idle_error;
+};
+
+/**
+   Updates submitted asynchronously, the worker thread is started with the
+   first submission.
+*/
+struct dd_DriverJob {
+  struct dd_DriverJob *next;
+  struct dd_DisplayDriverWrite write;
+  dd_display_driver_done_cb_t on_done;
+  void *data;
+};
+
+struct dd_DriverAsync {
+  mtx_t lock;
+  cnd_t wake;
+  thrd_t worker;
+  struct dd_DriverJob *head;
+  struct dd_DriverJob *tail;
+  int event_fd;
+  bool is_running;
+  bool is_stopping;
+};
 
 struct dd_DisplayDriver {
   dd_error_t (*write_part)(void *dd, unsigned char *buf, int buf_len, int x1,
@@ -8,15 +52,25 @@ struct dd_DisplayDriver {
   dd_error_t (*write_fast)(void *dd, unsigned char *buf, int buf_len);
   dd_error_t (*write)(void *dd, unsigned char *buf, int buf_len);
   dd_error_t (*clear)(void *dd, bool white);
+  dd_error_t (*sleep)(void *dd); // Power off and deep sleep if panel is awake
   void (*destroy)(void *dd);
 
   void *driver_data;
   int stride;
   int x;
   int y;
+
+  struct dd_DriverSession session;
+  struct dd_DriverAsync async;
 };
 
+dd_error_t dd_driver_init(dd_display_driver_t);
 void dd_driver_destroy(dd_display_driver_t *);
+dd_error_t dd_driver_session_open(dd_display_driver_t, int);
+dd_error_t dd_driver_session_close(dd_display_driver_t);
+dd_error_t dd_driver_submit(dd_display_driver_t, struct dd_DisplayDriverWrite *,
+                            dd_display_driver_done_cb_t, void *);
+int dd_driver_get_event_fd(dd_display_driver_t);
 dd_error_t dd_driver_write(dd_display_driver_t, unsigned char *, int);
 dd_error_t dd_driver_write_fast(dd_display_driver_t, unsigned char *, int);
 dd_error_t dd_driver_write_part(dd_display_driver_t, unsigned char *, uint32_t,
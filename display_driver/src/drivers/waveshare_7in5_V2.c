@@ -18,6 +18,11 @@
 #define DD_WVS75V2_WIDTH 800
 #define DD_WVS75V2_HEIGTH 480
 #define DD_WVS75V2_BUF_LEN DD_WVS75V2_HEIGTH *DD_WVS75V2_HEIGTH / 8
+// Longest busy period is full refresh, BUSY stuck for longer means that
+// controller hangs.
+#ifndef DD_WVS75V2_BUSY_TIMEOUT_MS
+#define DD_WVS75V2_BUSY_TIMEOUT_MS 10000
+#endif
 
 typedef struct dd_Wvs75v2 *dd_wvs75v2_t;
 
@@ -67,6 +72,19 @@ enum dd_Wvs75v2Cmd {
   dd_Wvs75v2Cmd_FLASH_MODE = 0xe5,
 };
 
+/**
+   Each kind of update initializes controller differently, panel awake in
+   the same mode can be updated without power on sequence. Reset controller
+   is awake but not configured for any of them.
+*/
+enum dd_Wvs75v2Mode {
+  dd_Wvs75v2Mode_SLEEP = 0,
+  dd_Wvs75v2Mode_RESET,
+  dd_Wvs75v2Mode_FULL,
+  dd_Wvs75v2Mode_FAST,
+  dd_Wvs75v2Mode_PART,
+};
+
 struct dd_Wvs75v2 {
   // GPIO
   struct dd_Gpio gpio;
@@ -81,6 +99,9 @@ struct dd_Wvs75v2 {
   // Settings
   bool is_rotated;
   unsigned char *rotation_buf;
+
+  // State
+  enum dd_Wvs75v2Mode mode;
 };
 
 static dd_error_t dd_driver_wvs75v2_write_part(void *, unsigned char *, int,
@@ -88,9 +109,14 @@ static dd_error_t dd_driver_wvs75v2_write_part(void *, unsigned char *, int,
 static dd_error_t dd_driver_wvs75v2_write_fast(void *, unsigned char *, int);
 static dd_error_t dd_driver_wvs75v2_write(void *, unsigned char *, int);
 static dd_error_t dd_driver_wvs75v2_clear(void *, bool);
+static dd_error_t dd_driver_wvs75v2_sleep(void *);
 static void dd_driver_wvs75v2_remove(void *);
+static dd_error_t dd_driver_wvs75v2_ops_wake(dd_wvs75v2_t,
+                                             enum dd_Wvs75v2Mode);
 static dd_error_t dd_driver_wvs75v2_ops_reset(dd_wvs75v2_t);
 static dd_error_t dd_driver_wvs75v2_ops_power_on(dd_wvs75v2_t);
+static dd_error_t dd_driver_wvs75v2_ops_power_on_fast(dd_wvs75v2_t);
+static dd_error_t dd_driver_wvs75v2_ops_power_on_part(dd_wvs75v2_t);
 static dd_error_t dd_driver_wvs75v2_ops_power_off(dd_wvs75v2_t);
 static dd_error_t dd_driver_wvs75v2_ops_clear(dd_wvs75v2_t, bool);
 static dd_error_t dd_driver_wvs75v2_ops_display_full(dd_wvs75v2_t,
@@ -136,7 +162,7 @@ dd_error_t dd_driver_wvs7in5v2_init(dd_display_driver_t out, void *config) {
   dd_errno = dd_gpio_add_pin(conf->bsy.gpio_chip_path, conf->bsy.pin_no,
                              &wvs->bsy, &wvs->gpio);
   DD_TRY_CATCH(dd_errno, error_dd_cleanup);
-  dd_errno = dd_gpio_set_pin_input(wvs->bsy);
+  dd_errno = dd_gpio_set_pin_input_events(wvs->bsy);
   DD_TRY_CATCH(dd_errno, error_dd_cleanup);
 
   dd_errno = dd_gpio_add_pin(conf->pwr.gpio_chip_path, conf->pwr.pin_no,
@@ -151,6 +177,7 @@ dd_error_t dd_driver_wvs7in5v2_init(dd_display_driver_t out, void *config) {
       .destroy = dd_driver_wvs75v2_remove,
       .write = dd_driver_wvs75v2_write,
       .clear = dd_driver_wvs75v2_clear,
+      .sleep = dd_driver_wvs75v2_sleep,
       .driver_data = wvs,
       .stride = stride,
       .x = x,
@@ -172,49 +199,94 @@ err_out:
 
 static dd_error_t dd_driver_wvs75v2_clear(void *driver, bool is_white) {
   dd_wvs75v2_t wvs = driver;
-  dd_driver_wvs75v2_ops_power_on(wvs);
-  DD_TRY(dd_errno);
+  dd_errno = dd_driver_wvs75v2_ops_wake(wvs, dd_Wvs75v2Mode_FULL);
+  DD_TRY_CATCH(dd_errno, error_wvs75v2_cleanup);
 
   dd_errno = dd_driver_wvs75v2_ops_clear(wvs, is_white);
   DD_TRY_CATCH(dd_errno, error_wvs75v2_cleanup);
 
-  dd_driver_wvs75v2_ops_power_off(wvs);
-  DD_TRY(dd_errno);
-
   return 0;
 
 error_wvs75v2_cleanup:
-  dd_driver_wvs75v2_ops_power_off(wvs);
-error_out:
+  DD_CLEANUP(dd_driver_wvs75v2_sleep(wvs));
   return dd_errno;
 }
 
 static dd_error_t dd_driver_wvs75v2_write(void *dd, unsigned char *buf,
                                           int buf_len) {
   dd_wvs75v2_t wvs = dd;
-  dd_driver_wvs75v2_ops_power_on(wvs);
-  DD_TRY(dd_errno);
+  dd_errno = dd_driver_wvs75v2_ops_wake(wvs, dd_Wvs75v2Mode_FULL);
+  DD_TRY_CATCH(dd_errno, error_wvs75v2_cleanup);
 
   dd_errno = dd_driver_wvs75v2_ops_display_full(wvs, buf, buf_len);
   DD_TRY_CATCH(dd_errno, error_wvs75v2_cleanup);
 
-  dd_driver_wvs75v2_ops_power_off(wvs);
+  return 0;
+
+error_wvs75v2_cleanup:
+  DD_CLEANUP(dd_driver_wvs75v2_sleep(wvs));
+  return dd_errno;
+}
+
+static dd_error_t dd_driver_wvs75v2_sleep(void *dd) {
+  dd_wvs75v2_t wvs = dd;
+  if (wvs->mode == dd_Wvs75v2Mode_SLEEP) {
+    return 0;
+  }
+
+  wvs->mode = dd_Wvs75v2Mode_SLEEP;
+  dd_errno = dd_driver_wvs75v2_ops_power_off(wvs);
   DD_TRY(dd_errno);
 
   return 0;
 
-error_wvs75v2_cleanup:
-  dd_driver_wvs75v2_ops_power_off(wvs);
 error_out:
   return dd_errno;
 }
 
-static void dd_wvs75v2_wait(struct dd_Wvs75v2 *display) {
-  /* puts("Busy waiting"); */
-  while (dd_gpio_read_pin(display->bsy, &display->gpio) != dd_Wvs75v2Bsy_IDLE) {
-    dd_sleep_ms(10);
+static dd_error_t dd_driver_wvs75v2_ops_wake(dd_wvs75v2_t dd,
+                                             enum dd_Wvs75v2Mode mode) {
+  if (dd->mode == mode) {
+    return 0;
   }
-  /* puts("Waiting done"); */
+
+  switch (mode) {
+  case dd_Wvs75v2Mode_SLEEP:
+    dd_errno = dd_driver_wvs75v2_sleep(dd);
+    break;
+  case dd_Wvs75v2Mode_RESET:
+    dd_errno = dd_driver_wvs75v2_ops_reset(dd);
+    break;
+  case dd_Wvs75v2Mode_FULL:
+    dd_errno = dd_driver_wvs75v2_ops_power_on(dd);
+    break;
+  case dd_Wvs75v2Mode_FAST:
+    dd_errno = dd_driver_wvs75v2_ops_power_on_fast(dd);
+    break;
+  case dd_Wvs75v2Mode_PART:
+    dd_errno = dd_driver_wvs75v2_ops_power_on_part(dd);
+    break;
+  }
+  DD_TRY(dd_errno);
+
+  dd->mode = mode;
+
+  return 0;
+
+error_out:
+  dd->mode = dd_Wvs75v2Mode_RESET; // Failed power on resets the controller
+  return dd_errno;
+}
+
+static dd_error_t dd_wvs75v2_wait(struct dd_Wvs75v2 *display) {
+  dd_errno = dd_gpio_wait_pin(dd_Wvs75v2Bsy_IDLE, DD_WVS75V2_BUSY_TIMEOUT_MS,
+                              display->bsy, &display->gpio);
+  DD_TRY(dd_errno);
+
+  return 0;
+
+error_out:
+  return dd_errno;
 }
 
 static void dd_driver_wvs75v2_remove(void *dd) {
@@ -237,6 +309,10 @@ static void dd_driver_wvs75v2_remove(void *dd) {
 }
 
 static dd_error_t dd_driver_wvs75v2_ops_reset(dd_wvs75v2_t dd) {
+  // Next update has to power the controller on again, sleep still has to
+  // power it off.
+  dd->mode = dd_Wvs75v2Mode_RESET;
+
   if (dd_gpio_read_pin(dd->pwr, &dd->gpio) != 1) {
     dd_errno = dd_gpio_set_pin(1, dd->pwr, &dd->gpio);
     DD_TRY(dd_errno);
@@ -255,7 +331,9 @@ static dd_error_t dd_driver_wvs75v2_ops_reset(dd_wvs75v2_t dd) {
   DD_TRY_CATCH(dd_errno, error_rst_cleanup);
   dd_sleep_ms(200);
 
-  dd_wvs75v2_wait(dd); // Give chip time to reset itself
+  // Give chip time to reset itself
+  dd_errno = dd_wvs75v2_wait(dd);
+  DD_TRY(dd_errno);
 
   return 0;
 
@@ -292,6 +370,41 @@ error_out:
   return dd_errno;
 }
 
+static dd_error_t dd_wvs75v2_send_data_repeated(struct dd_Wvs75v2 *dd,
+                                                uint8_t data, uint32_t len) {
+  dd_errno = dd_gpio_set_pin(dd_Wvs75v2Dc_DATA, dd->dc, &dd->gpio);
+  DD_TRY(dd_errno);
+
+  dd_errno = dd_spi_send_repeated(data, len, &dd->spi);
+  DD_TRY(dd_errno);
+
+  return 0;
+
+error_out:
+  return dd_errno;
+}
+
+/**
+   Panel expects inverted colors in some of transmissions. Plane is inverted
+   as a whole so DC is set once and spi can split it into fewest messages.
+*/
+static dd_error_t dd_wvs75v2_send_data_inverted(struct dd_Wvs75v2 *dd,
+                                                uint8_t *data, uint32_t len) {
+  uint8_t *inverted = dd_malloc(len);
+  for (uint32_t i = 0; i < len; i++) {
+    inverted[i] = ~data[i];
+  }
+
+  dd_errno = dd_wvs75v2_send_data(dd, inverted, len);
+  dd_free(inverted);
+  DD_TRY(dd_errno);
+
+  return 0;
+
+error_out:
+  return dd_errno;
+}
+
 static dd_error_t dd_driver_wvs75v2_ops_power_on(dd_wvs75v2_t dd) {
   if (dd_gpio_read_pin(dd->pwr, &dd->gpio) != 1) {
     dd_errno = dd_gpio_set_pin(1, dd->pwr, &dd->gpio);
@@ -334,7 +447,8 @@ static dd_error_t dd_driver_wvs75v2_ops_power_on(dd_wvs75v2_t dd) {
   dd_errno = dd_wvs75v2_send_cmd(dd, dd_Wvs75v2Cmd_POWER_ON);
   DD_TRY_CATCH(dd_errno, error_dd_cleanup);
   dd_sleep_ms(100);
-  dd_wvs75v2_wait(dd);
+  dd_errno = dd_wvs75v2_wait(dd);
+  DD_TRY_CATCH(dd_errno, error_dd_cleanup);
 
   dd_errno = dd_wvs75v2_send_cmd(dd, dd_Wvs75v2Cmd_PANEL_SETTING);
   DD_TRY_CATCH(dd_errno, error_dd_cleanup);
@@ -386,12 +500,13 @@ static dd_error_t dd_driver_wvs75v2_ops_power_on(dd_wvs75v2_t dd) {
                                   1);
   DD_TRY_CATCH(dd_errno, error_dd_cleanup);
 
-  dd_wvs75v2_wait(dd);
+  dd_errno = dd_wvs75v2_wait(dd);
+  DD_TRY_CATCH(dd_errno, error_dd_cleanup);
 
   return 0;
 
 error_dd_cleanup:
-  dd_driver_wvs75v2_ops_reset(dd);
+  DD_CLEANUP(dd_driver_wvs75v2_ops_reset(dd));
 error_out:
   return dd_errno;
 }
@@ -399,44 +514,38 @@ error_out:
 static dd_error_t dd_driver_wvs75v2_ops_clear(dd_wvs75v2_t dd, bool white) {
   dd_errno = dd_wvs75v2_send_cmd(dd, dd_Wvs75v2Cmd_START_TRANSMISSION1);
   DD_TRY_CATCH(dd_errno, error_dd_cleanup);
-  for (int i = 0; i < DD_WVS75V2_HEIGTH * (DD_WVS75V2_WIDTH / 8); i++) {
-    dd_errno = dd_wvs75v2_send_data(dd,
-                                    (uint8_t[]){
-                                        white ? 0x00 : 0xFF,
-                                    },
-                                    1);
-    DD_TRY_CATCH(dd_errno, error_dd_cleanup);
-  }
-  dd_wvs75v2_wait(dd);
+  dd_errno = dd_wvs75v2_send_data_repeated(
+      dd, white ? 0x00 : 0xFF, DD_WVS75V2_HEIGTH * (DD_WVS75V2_WIDTH / 8));
+  DD_TRY_CATCH(dd_errno, error_dd_cleanup);
+  dd_errno = dd_wvs75v2_wait(dd);
+  DD_TRY_CATCH(dd_errno, error_dd_cleanup);
 
   dd_errno = dd_wvs75v2_send_cmd(dd, dd_Wvs75v2Cmd_START_TRANSMISSION2);
   DD_TRY_CATCH(dd_errno, error_dd_cleanup);
-  for (int i = 0; i < DD_WVS75V2_HEIGTH * (DD_WVS75V2_WIDTH / 8); i++) {
-    dd_errno = dd_wvs75v2_send_data(dd,
-                                    (uint8_t[]){
-                                        white ? 0x00 : 0xFF,
-                                    },
-                                    1);
-    DD_TRY_CATCH(dd_errno, error_dd_cleanup);
-  }
-  dd_wvs75v2_wait(dd);
+  dd_errno = dd_wvs75v2_send_data_repeated(
+      dd, white ? 0x00 : 0xFF, DD_WVS75V2_HEIGTH * (DD_WVS75V2_WIDTH / 8));
+  DD_TRY_CATCH(dd_errno, error_dd_cleanup);
+  dd_errno = dd_wvs75v2_wait(dd);
+  DD_TRY_CATCH(dd_errno, error_dd_cleanup);
 
   dd_errno = dd_wvs75v2_send_cmd(dd, dd_Wvs75v2Cmd_DISPLAY_REFRESH);
   DD_TRY_CATCH(dd_errno, error_dd_cleanup);
   dd_sleep_ms(100);
-  dd_wvs75v2_wait(dd);
+  dd_errno = dd_wvs75v2_wait(dd);
+  DD_TRY_CATCH(dd_errno, error_dd_cleanup);
 
   return 0;
 
 error_dd_cleanup:
-  dd_driver_wvs75v2_ops_reset(dd);
+  DD_CLEANUP(dd_driver_wvs75v2_ops_reset(dd));
   return dd_errno;
 }
 
 static dd_error_t dd_driver_wvs75v2_ops_power_off(dd_wvs75v2_t dd) {
   dd_errno = dd_wvs75v2_send_cmd(dd, dd_Wvs75v2Cmd_POWER_OFF);
   DD_TRY_CATCH(dd_errno, error_dd_cleanup);
-  dd_wvs75v2_wait(dd);
+  dd_errno = dd_wvs75v2_wait(dd);
+  DD_TRY_CATCH(dd_errno, error_dd_cleanup);
 
   dd_errno = dd_wvs75v2_send_cmd(dd, dd_Wvs75v2Cmd_DEEP_SLEEP);
   DD_TRY_CATCH(dd_errno, error_dd_cleanup);
@@ -448,7 +557,7 @@ static dd_error_t dd_driver_wvs75v2_ops_power_off(dd_wvs75v2_t dd) {
   return 0;
 
 error_dd_cleanup:
-  dd_driver_wvs75v2_ops_reset(dd);
+  DD_CLEANUP(dd_driver_wvs75v2_ops_reset(dd));
   return dd_errno;
 }
 
@@ -478,47 +587,30 @@ static dd_error_t dd_driver_wvs75v2_ops_display_full(dd_wvs75v2_t dd,
 
   dd_errno = dd_wvs75v2_send_cmd(dd, dd_Wvs75v2Cmd_START_TRANSMISSION1);
   DD_TRY_CATCH(dd_errno, out);
-  uint8_t chunk[1024] = {0};
-  for (int i = 0; i < buf_len; i += sizeof(chunk)) {
-    int chunk_size = sizeof(chunk);
-    if (i + chunk_size > buf_len) {
-      chunk_size = buf_len - i;
-    }
-
-    dd_errno = dd_wvs75v2_send_data(dd, chunk, chunk_size);
-    DD_TRY_CATCH(dd_errno, out);
-  }
-  dd_wvs75v2_wait(dd);
+  dd_errno = dd_wvs75v2_send_data_repeated(dd, 0x00, buf_len);
+  DD_TRY_CATCH(dd_errno, out);
+  dd_errno = dd_wvs75v2_wait(dd);
+  DD_TRY_CATCH(dd_errno, out);
 
   dd_errno = dd_wvs75v2_send_cmd(dd, dd_Wvs75v2Cmd_START_TRANSMISSION2);
   DD_TRY_CATCH(dd_errno, out);
+  dd_errno = dd_wvs75v2_send_data_inverted(dd, buf, buf_len);
+  DD_TRY_CATCH(dd_errno, out);
 
-  for (int i = 0; i < buf_len; i += sizeof(chunk)) {
-    int chunk_size = sizeof(chunk);
-    if (i + chunk_size > buf_len) {
-      chunk_size = buf_len - i;
-    }
-
-    for (int chunk_i = 0; chunk_i < chunk_size; chunk_i++) {
-      chunk[chunk_i] = ~(*(buf + i + chunk_i));
-    }
-
-    dd_errno = dd_wvs75v2_send_data(dd, chunk, chunk_size);
-    DD_TRY_CATCH(dd_errno, out);
-  }
-
-  dd_wvs75v2_wait(dd);
+  dd_errno = dd_wvs75v2_wait(dd);
+  DD_TRY_CATCH(dd_errno, out);
 
   dd_errno = dd_wvs75v2_send_cmd(dd, dd_Wvs75v2Cmd_DISPLAY_REFRESH);
   DD_TRY_CATCH(dd_errno, out);
-  dd_wvs75v2_wait(dd);
+  dd_errno = dd_wvs75v2_wait(dd);
+  DD_TRY_CATCH(dd_errno, out);
 
 out:
   if (dd->is_rotated) {
     dd_free(buf);
   }
   if (dd_errno) {
-    dd_driver_wvs75v2_ops_reset(dd);
+    DD_CLEANUP(dd_driver_wvs75v2_ops_reset(dd));
   }
   return dd_errno;
 };
@@ -549,7 +641,8 @@ static dd_error_t dd_driver_wvs75v2_ops_power_on_part(dd_wvs75v2_t dd) {
   dd_errno = dd_wvs75v2_send_cmd(dd, dd_Wvs75v2Cmd_POWER_ON);
   DD_TRY_CATCH(dd_errno, error_dd_cleanup);
   dd_sleep_ms(100);
-  dd_wvs75v2_wait(dd);
+  dd_errno = dd_wvs75v2_wait(dd);
+  DD_TRY_CATCH(dd_errno, error_dd_cleanup);
 
   dd_errno = dd_wvs75v2_send_cmd(dd, dd_Wvs75v2Cmd_CASCADE_SETTING);
   DD_TRY_CATCH(dd_errno, error_dd_cleanup);
@@ -569,12 +662,13 @@ static dd_error_t dd_driver_wvs75v2_ops_power_on_part(dd_wvs75v2_t dd) {
                                   1);
   DD_TRY_CATCH(dd_errno, error_dd_cleanup);
 
-  dd_wvs75v2_wait(dd);
+  dd_errno = dd_wvs75v2_wait(dd);
+  DD_TRY_CATCH(dd_errno, error_dd_cleanup);
 
   return 0;
 
 error_dd_cleanup:
-  dd_driver_wvs75v2_ops_reset(dd);
+  DD_CLEANUP(dd_driver_wvs75v2_ops_reset(dd));
 error_out:
   return dd_errno;
 }
@@ -584,20 +678,16 @@ static dd_error_t dd_driver_wvs75v2_write_part(void *dd, unsigned char *buf,
                                                int y1, int y2) {
   dd_wvs75v2_t wvs = dd;
 
-  dd_driver_wvs75v2_ops_power_on_part(wvs);
-  DD_TRY(dd_errno);
+  dd_errno = dd_driver_wvs75v2_ops_wake(wvs, dd_Wvs75v2Mode_PART);
+  DD_TRY_CATCH(dd_errno, error_wvs75v2_cleanup);
   dd_errno =
       dd_driver_wvs75v2_ops_display_partial(wvs, buf, buf_len, x1, x2, y1, y2);
   DD_TRY_CATCH(dd_errno, error_wvs75v2_cleanup);
 
-  dd_driver_wvs75v2_ops_power_off(wvs);
-  DD_TRY(dd_errno);
-
   return 0;
 
 error_wvs75v2_cleanup:
-  dd_driver_wvs75v2_ops_power_off(wvs);
-error_out:
+  DD_CLEANUP(dd_driver_wvs75v2_sleep(wvs));
   return dd_errno;
 }
 
@@ -662,27 +752,24 @@ static dd_error_t dd_driver_wvs75v2_ops_display_partial(dd_wvs75v2_t dd,
   dd_errno = dd_wvs75v2_send_cmd(dd, dd_Wvs75v2Cmd_START_TRANSMISSION1);
   DD_TRY(dd_errno);
 
-  for (int i = 0; i < buf_len; i++) {
-    dd_errno = dd_wvs75v2_send_data(dd, (uint8_t[]){~buf[i]}, 1);
-    DD_TRY(dd_errno);
-  }
+  dd_errno = dd_wvs75v2_send_data_inverted(dd, buf, buf_len);
+  DD_TRY(dd_errno);
 
   dd_errno = dd_wvs75v2_send_cmd(dd, dd_Wvs75v2Cmd_START_TRANSMISSION2);
   DD_TRY(dd_errno);
 
-  for (int i = 0; i < buf_len; i++) {
-    dd_errno = dd_wvs75v2_send_data(dd, (uint8_t[]){buf[i]}, 1);
-    DD_TRY(dd_errno);
-  }
+  dd_errno = dd_wvs75v2_send_data(dd, buf, buf_len);
+  DD_TRY(dd_errno);
   dd_errno = dd_wvs75v2_send_cmd(dd, dd_Wvs75v2Cmd_DISPLAY_REFRESH);
   DD_TRY(dd_errno);
   dd_sleep_ms(100);
-  dd_wvs75v2_wait(dd);
+  dd_errno = dd_wvs75v2_wait(dd);
+  DD_TRY(dd_errno);
 
   return 0;
 
 error_out:
-  dd_driver_wvs75v2_ops_reset(dd);
+  DD_CLEANUP(dd_driver_wvs75v2_ops_reset(dd));
   return dd_errno;
 }
 
@@ -723,7 +810,8 @@ static dd_error_t dd_driver_wvs75v2_ops_power_on_fast(dd_wvs75v2_t dd) {
   dd_errno = dd_wvs75v2_send_cmd(dd, dd_Wvs75v2Cmd_POWER_ON);
   DD_TRY_CATCH(dd_errno, error_dd_cleanup);
   dd_sleep_ms(100);
-  dd_wvs75v2_wait(dd);
+  dd_errno = dd_wvs75v2_wait(dd);
+  DD_TRY_CATCH(dd_errno, error_dd_cleanup);
 
   dd_errno = dd_wvs75v2_send_cmd(dd, dd_Wvs75v2Cmd_BOOSTER_SOFT_START);
   DD_TRY_CATCH(dd_errno, error_dd_cleanup);
@@ -755,12 +843,13 @@ static dd_error_t dd_driver_wvs75v2_ops_power_on_fast(dd_wvs75v2_t dd) {
                                   1);
   DD_TRY_CATCH(dd_errno, error_dd_cleanup);
 
-  dd_wvs75v2_wait(dd);
+  dd_errno = dd_wvs75v2_wait(dd);
+  DD_TRY_CATCH(dd_errno, error_dd_cleanup);
 
   return 0;
 
 error_dd_cleanup:
-  dd_driver_wvs75v2_ops_reset(dd);
+  DD_CLEANUP(dd_driver_wvs75v2_ops_reset(dd));
 error_out:
   return dd_errno;
 }
@@ -769,18 +858,14 @@ static dd_error_t dd_driver_wvs75v2_write_fast(void *dd, unsigned char *buf,
                                                int buf_len) {
   dd_wvs75v2_t wvs = dd;
 
-  dd_driver_wvs75v2_ops_power_on_fast(wvs);
-  DD_TRY(dd_errno);
+  dd_errno = dd_driver_wvs75v2_ops_wake(wvs, dd_Wvs75v2Mode_FAST);
+  DD_TRY_CATCH(dd_errno, error_wvs75v2_cleanup);
   dd_errno = dd_driver_wvs75v2_ops_display_full(wvs, buf, buf_len);
   DD_TRY_CATCH(dd_errno, error_wvs75v2_cleanup);
 
-  dd_driver_wvs75v2_ops_power_off(wvs);
-  DD_TRY(dd_errno);
-
   return 0;
 
 error_wvs75v2_cleanup:
-  dd_driver_wvs75v2_ops_power_off(wvs);
-error_out:
+  DD_CLEANUP(dd_driver_wvs75v2_sleep(wvs));
   return dd_errno;
 }
@@ -13,6 +13,11 @@
 #define DD_WVS75V2B_WIDTH 800
 #define DD_WVS75V2B_HEIGTH 480
 #define DD_WVS75V2B_BUF_LEN DD_WVS75V2B_HEIGTH *DD_WVS75V2B_HEIGTH / 8
+// Longest busy period is full refresh, BUSY stuck for longer means that
+// controller hangs.
+#ifndef DD_WVS75V2B_BUSY_TIMEOUT_MS
+#define DD_WVS75V2B_BUSY_TIMEOUT_MS 30000
+#endif
 
 enum dd_Wvs75V2bBsy {
   dd_Wvs75V2bBsy_BUSY = 0,
@@ -58,13 +63,19 @@ struct dd_Wvs75V2b {
 
   // Settings
   bool is_rotated;
+
+  // State
+  bool is_awake;
+  bool is_configured;
 };
 
 typedef struct dd_Wvs75V2b *dd_wvs75v2b_t;
 
 static dd_error_t dd_wvs75v2b_write(void *, unsigned char *, int);
 static dd_error_t dd_wvs75v2b_clear(void *, bool);
+static dd_error_t dd_wvs75v2b_sleep(void *);
 static void dd_wvs75v2b_remove(void *);
+static dd_error_t dd_wvs75v2b_ops_wake(dd_wvs75v2b_t);
 static dd_error_t dd_wvs75v2b_ops_reset(dd_wvs75v2b_t);
 static dd_error_t dd_wvs75v2b_ops_power_on(dd_wvs75v2b_t);
 static dd_error_t dd_wvs75v2b_ops_power_off(dd_wvs75v2b_t);
@@ -108,7 +119,7 @@ dd_error_t dd_driver_wvs7in5v2b_init(dd_display_driver_t out, void *config) {
   dd_errno = dd_gpio_add_pin(conf->bsy.gpio_chip_path, conf->bsy.pin_no,
                              &wvs->bsy, &wvs->gpio);
   DD_TRY_CATCH(dd_errno, error_dd_cleanup);
-  dd_errno = dd_gpio_set_pin_input(wvs->bsy);
+  dd_errno = dd_gpio_set_pin_input_events(wvs->bsy);
   DD_TRY_CATCH(dd_errno, error_dd_cleanup);
 
   dd_errno = dd_gpio_add_pin(conf->pwr.gpio_chip_path, conf->pwr.pin_no,
@@ -124,6 +135,7 @@ dd_error_t dd_driver_wvs7in5v2b_init(dd_display_driver_t out, void *config) {
   *out = (struct dd_DisplayDriver){
       .write = dd_wvs75v2b_write,
       .clear = dd_wvs75v2b_clear,
+      .sleep = dd_wvs75v2b_sleep,
       .destroy = dd_wvs75v2b_remove,
       .driver_data = wvs,
       .stride = stride,
@@ -146,40 +158,65 @@ err_out:
 
 static dd_error_t dd_wvs75v2b_clear(void *dd, bool white) {
   dd_wvs75v2b_t driver_data = dd;
-  dd_wvs75v2b_ops_power_on(driver_data);
-  DD_TRY(dd_errno);
+  dd_errno = dd_wvs75v2b_ops_wake(driver_data);
+  DD_TRY_CATCH(dd_errno, error_wvs75v2b_cleanup);
 
   dd_errno = dd_wvs75v2b_ops_clear(driver_data, white);
   DD_TRY_CATCH(dd_errno, error_wvs75v2b_cleanup);
 
-  dd_wvs75v2b_ops_power_off(driver_data);
-  DD_TRY(dd_errno);
-
   return 0;
 
 error_wvs75v2b_cleanup:
-  dd_wvs75v2b_ops_power_off(driver_data);
-error_out:
+  DD_CLEANUP(dd_wvs75v2b_sleep(driver_data));
   return dd_errno;
 };
 
 static dd_error_t dd_wvs75v2b_write(void *dd, unsigned char *buf, int buf_len) {
   dd_wvs75v2b_t driver_data = dd;
-  dd_wvs75v2b_ops_power_on(driver_data);
-  DD_TRY(dd_errno);
+  dd_errno = dd_wvs75v2b_ops_wake(driver_data);
+  DD_TRY_CATCH(dd_errno, error_display_cleanup);
 
   dd_errno = dd_wvs75v2b_ops_display_full(driver_data, buf, buf_len);
   DD_TRY_CATCH(dd_errno, error_display_cleanup);
 
-  dd_wvs75v2b_ops_power_off(driver_data);
+  return 0;
+error_display_cleanup:
+  DD_CLEANUP(dd_wvs75v2b_sleep(driver_data));
+  return dd_errno;
+};
+
+static dd_error_t dd_wvs75v2b_sleep(void *dd) {
+  dd_wvs75v2b_t driver_data = dd;
+  if (!driver_data->is_awake) {
+    return 0;
+  }
+
+  driver_data->is_awake = false;
+  dd_errno = dd_wvs75v2b_ops_power_off(driver_data);
   DD_TRY(dd_errno);
 
   return 0;
-error_display_cleanup:
-  dd_wvs75v2b_ops_power_off(driver_data);
+
 error_out:
   return dd_errno;
-};
+}
+
+static dd_error_t dd_wvs75v2b_ops_wake(dd_wvs75v2b_t dd) {
+  if (dd->is_awake && dd->is_configured) {
+    return 0;
+  }
+
+  dd_errno = dd_wvs75v2b_ops_power_on(dd);
+  DD_TRY(dd_errno);
+
+  dd->is_awake = true;
+  dd->is_configured = true;
+
+  return 0;
+
+error_out:
+  return dd_errno;
+}
 
 static void dd_wvs75v2b_remove(void *dd) {
   dd_wvs75v2b_t driver_data = dd;
@@ -227,13 +264,29 @@ error_out:
   return dd_errno;
 }
 
-static void dd_wvs75v2b_wait(struct dd_Wvs75V2b *display) {
-  /* puts("Busy waiting"); */
-  while (dd_gpio_read_pin(display->bsy, &display->gpio) !=
-         dd_Wvs75V2bBsy_IDLE) {
-    dd_sleep_ms(10);
-  }
-  /* puts("Waiting done"); */
+static dd_error_t dd_wvs75v2b_send_data_repeated(struct dd_Wvs75V2b *dd,
+                                                 uint8_t data, int len) {
+  dd_errno = dd_gpio_set_pin(dd_Wvs75V2bDc_DATA, dd->dc, &dd->gpio);
+  DD_TRY(dd_errno);
+
+  dd_errno = dd_spi_send_repeated(data, len, &dd->spi);
+  DD_TRY(dd_errno);
+
+  return 0;
+
+error_out:
+  return dd_errno;
+}
+
+static dd_error_t dd_wvs75v2b_wait(struct dd_Wvs75V2b *display) {
+  dd_errno = dd_gpio_wait_pin(dd_Wvs75V2bBsy_IDLE, DD_WVS75V2B_BUSY_TIMEOUT_MS,
+                              display->bsy, &display->gpio);
+  DD_TRY(dd_errno);
+
+  return 0;
+
+error_out:
+  return dd_errno;
 }
 
 static dd_error_t dd_wvs75v2b_ops_reset(dd_wvs75v2b_t dd) {
@@ -244,6 +297,11 @@ static dd_error_t dd_wvs75v2b_ops_reset(dd_wvs75v2b_t dd) {
     goto error_out;
   }
 
+  // Next update has to power the controller on again, sleep still has to
+  // power it off.
+  dd->is_awake = true;
+  dd->is_configured = false;
+
   if (dd_gpio_read_pin(dd->pwr, &dd->gpio) != 1) {
     dd_errno = dd_gpio_set_pin(1, dd->pwr, &dd->gpio);
     DD_TRY(dd_errno);
@@ -262,7 +320,9 @@ static dd_error_t dd_wvs75v2b_ops_reset(dd_wvs75v2b_t dd) {
   DD_TRY(dd_errno);
   dd_sleep_ms(200);
 
-  dd_wvs75v2b_wait(dd); // Give chip time to reset itself
+  // Give chip time to reset itself
+  dd_errno = dd_wvs75v2b_wait(dd);
+  DD_TRY(dd_errno);
 
   return 0;
 
@@ -366,12 +426,13 @@ static dd_error_t dd_wvs75v2b_ops_power_on(dd_wvs75v2b_t dd) {
   DD_TRY_CATCH(dd_errno, error_dd_cleanup);
   dd_errno = dd_wvs75v2b_send_data(dd, (uint8_t[]){0x22}, 1);
   DD_TRY_CATCH(dd_errno, error_dd_cleanup);
-  dd_wvs75v2b_wait(dd);
+  dd_errno = dd_wvs75v2b_wait(dd);
+  DD_TRY_CATCH(dd_errno, error_dd_cleanup);
 
   return 0;
 
 error_dd_cleanup:
-  dd_wvs75v2b_ops_reset(dd);
+  DD_CLEANUP(dd_wvs75v2b_ops_reset(dd));
 error_out:
   return dd_errno;
 }
@@ -386,34 +447,31 @@ static dd_error_t dd_wvs75v2b_ops_clear(dd_wvs75v2b_t dd, bool white) {
 
   dd_errno = dd_wvs75v2b_send_cmd(dd, dd_Wvs75V2bCmd_START_TRANSMISSION1);
   DD_TRY_CATCH(dd_errno, error_dd_cleanup);
-  for (int i = 0; i < DD_WVS75V2B_HEIGTH * (DD_WVS75V2B_WIDTH / 8); i++) {
-    dd_errno = dd_wvs75v2b_send_data(dd,
-                                     (uint8_t[]){
-                                         white ? 0xFF : 0x00,
-                                     },
-                                     1);
-    DD_TRY_CATCH(dd_errno, error_dd_cleanup);
-  }
-  dd_wvs75v2b_wait(dd);
+  dd_errno = dd_wvs75v2b_send_data_repeated(
+      dd, white ? 0xFF : 0x00, DD_WVS75V2B_HEIGTH * (DD_WVS75V2B_WIDTH / 8));
+  DD_TRY_CATCH(dd_errno, error_dd_cleanup);
+  dd_errno = dd_wvs75v2b_wait(dd);
+  DD_TRY_CATCH(dd_errno, error_dd_cleanup);
 
   dd_errno = dd_wvs75v2b_send_cmd(dd, dd_Wvs75V2bCmd_START_TRANSMISSION2);
   DD_TRY_CATCH(dd_errno, error_dd_cleanup);
-  for (int i = 0; i < DD_WVS75V2B_HEIGTH * (DD_WVS75V2B_WIDTH / 8); i++) {
-    dd_errno = dd_wvs75v2b_send_data(dd, (uint8_t[]){0x00}, 1);
-    DD_TRY_CATCH(dd_errno, error_dd_cleanup);
-  }
-  dd_wvs75v2b_wait(dd);
+  dd_errno = dd_wvs75v2b_send_data_repeated(
+      dd, 0x00, DD_WVS75V2B_HEIGTH * (DD_WVS75V2B_WIDTH / 8));
+  DD_TRY_CATCH(dd_errno, error_dd_cleanup);
+  dd_errno = dd_wvs75v2b_wait(dd);
+  DD_TRY_CATCH(dd_errno, error_dd_cleanup);
 
   dd_errno = dd_wvs75v2b_send_cmd(dd, dd_Wvs75V2bCmd_DISPLAY_REFRESH);
   DD_TRY_CATCH(dd_errno, error_dd_cleanup);
   dd_sleep_ms(100);
   dd_sleep_ms(1000);
-  dd_wvs75v2b_wait(dd);
+  dd_errno = dd_wvs75v2b_wait(dd);
+  DD_TRY_CATCH(dd_errno, error_dd_cleanup);
 
   return 0;
 
 error_dd_cleanup:
-  dd_wvs75v2b_ops_reset(dd);
+  DD_CLEANUP(dd_wvs75v2b_ops_reset(dd));
 error_out:
   return dd_errno;
 }
@@ -428,7 +486,8 @@ static dd_error_t dd_wvs75v2b_ops_power_off(dd_wvs75v2b_t dd) {
 
   dd_errno = dd_wvs75v2b_send_cmd(dd, dd_Wvs75V2bCmd_POWER_OFF);
   DD_TRY_CATCH(dd_errno, error_dd_cleanup);
-  dd_wvs75v2b_wait(dd);
+  dd_errno = dd_wvs75v2b_wait(dd);
+  DD_TRY_CATCH(dd_errno, error_dd_cleanup);
 
   dd_errno = dd_wvs75v2b_send_cmd(dd, dd_Wvs75V2bCmd_DEEP_SLEEP);
   DD_TRY_CATCH(dd_errno, error_dd_cleanup);
@@ -440,7 +499,7 @@ static dd_error_t dd_wvs75v2b_ops_power_off(dd_wvs75v2b_t dd) {
   return 0;
 
 error_dd_cleanup:
-  dd_wvs75v2b_ops_reset(dd);
+  DD_CLEANUP(dd_wvs75v2b_ops_reset(dd));
 error_out:
   return dd_errno;
 }
@@ -471,28 +530,24 @@ static dd_error_t dd_wvs75v2b_ops_display_full(dd_wvs75v2b_t dd,
                              buf_len);
   }
 
-  // The display does full refresh in about 18 seconds so sending
-  // byte by byte does not affect this time much. Real bottleneck is in screen.
-  // TO-DO: However we should use buffer here.
   dd_errno = dd_wvs75v2b_send_cmd(dd, dd_Wvs75V2bCmd_START_TRANSMISSION1);
   DD_TRY_CATCH(dd_errno, out);
-  for (int i = 0; i < buf_len; i++) {
-    dd_errno = dd_wvs75v2b_send_data(dd, (uint8_t[]){buf[i]}, 1);
-    DD_TRY_CATCH(dd_errno, out);
-  }
-  dd_wvs75v2b_wait(dd);
+  dd_errno = dd_wvs75v2b_send_data(dd, buf, buf_len);
+  DD_TRY_CATCH(dd_errno, out);
+  dd_errno = dd_wvs75v2b_wait(dd);
+  DD_TRY_CATCH(dd_errno, out);
 
   dd_errno = dd_wvs75v2b_send_cmd(dd, dd_Wvs75V2bCmd_START_TRANSMISSION2);
   DD_TRY_CATCH(dd_errno, out);
-  for (int i = 0; i < buf_len; i++) {
-    dd_errno = dd_wvs75v2b_send_data(dd, (uint8_t[]){0x00}, 1);
-    DD_TRY_CATCH(dd_errno, out);
-  }
-  dd_wvs75v2b_wait(dd);
+  dd_errno = dd_wvs75v2b_send_data_repeated(dd, 0x00, buf_len);
+  DD_TRY_CATCH(dd_errno, out);
+  dd_errno = dd_wvs75v2b_wait(dd);
+  DD_TRY_CATCH(dd_errno, out);
 
   dd_errno = dd_wvs75v2b_send_cmd(dd, dd_Wvs75V2bCmd_DISPLAY_REFRESH);
   DD_TRY_CATCH(dd_errno, out);
-  dd_wvs75v2b_wait(dd);
+  dd_errno = dd_wvs75v2b_wait(dd);
+  DD_TRY_CATCH(dd_errno, out);
 
 out:
   if (dd->is_rotated) {
@@ -501,7 +556,7 @@ out:
 
   if (dd_errno) {
 
-    dd_wvs75v2b_ops_reset(dd);
+    DD_CLEANUP(dd_wvs75v2b_ops_reset(dd));
   }
 
   return dd_errno;
@@ -1,12 +1,16 @@
 #define _GNU_SOURCE
 #include <gpiod.h>
 #include <string.h>
+#include <time.h>
 
 #include "display_driver.h"
 #include "gpio.h"
 #include "utils/err.h"
 #include "utils/list.h"
 #include "utils/mem.h"
+#include "utils/time.h"
+
+#define DD_GPIO_POLL_MS 10
 
 static void dd_gpio_pin_cleanup(void *data);
 static void dd_gpio_chip_cleanup(void *data);
@@ -122,6 +126,94 @@ error_out:
   return dd_errno;
 };
 
+dd_error_t dd_gpio_set_pin_input_events(struct dd_GpioPin *pin) {
+  int ret =
+      gpiod_line_request_both_edges_events(pin->private, "display_driver");
+  if (ret) {
+    dd_errno = dd_errnof(errno, "Unable to request edge events for %s:%d",
+                         pin->chip->path, pin->pin_no);
+    goto error_out;
+  }
+
+  pin->is_out = false;
+  pin->has_events = true;
+
+  return 0;
+
+error_out:
+  return dd_errno;
+};
+
+static int dd_gpio_ms_left(const struct timespec *deadline) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (deadline->tv_sec - now.tv_sec) * 1000 +
+         (deadline->tv_nsec - now.tv_nsec) / 1000000;
+}
+
+/**
+   Value is read before each wait. Edges which happen in between are queued
+   by the kernel, so the wait returns right away and no change is missed.
+   Pins without events are polled.
+*/
+dd_error_t dd_gpio_wait_pin(int value, int timeout_ms, struct dd_GpioPin *pin,
+                            struct dd_Gpio *gpio) {
+  struct timespec deadline;
+  clock_gettime(CLOCK_MONOTONIC, &deadline);
+  deadline.tv_sec += timeout_ms / 1000;
+  deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+  if (deadline.tv_nsec >= 1000000000L) {
+    deadline.tv_sec++;
+    deadline.tv_nsec -= 1000000000L;
+  }
+
+  for (;;) {
+    int ret = dd_gpio_read_pin(pin, gpio);
+    if (ret < 0) {
+      goto error_out;
+    }
+    if (ret == value) {
+      break;
+    }
+
+    int ms_left = dd_gpio_ms_left(&deadline);
+    if (ms_left <= 0) {
+      dd_errno = dd_errnof(ETIMEDOUT, "Timeout waiting for %s:%d=%d",
+                           pin->chip->path, pin->pin_no, value);
+      goto error_out;
+    }
+
+    if (!pin->has_events) {
+      dd_sleep_ms(ms_left < DD_GPIO_POLL_MS ? ms_left : DD_GPIO_POLL_MS);
+      continue;
+    }
+
+    struct timespec timeout = {
+        .tv_sec = ms_left / 1000,
+        .tv_nsec = (long)(ms_left % 1000) * 1000000L,
+    };
+    ret = gpiod_line_event_wait(pin->private, &timeout);
+    if (ret < 0) {
+      dd_errno = dd_errnof(errno, "Unable to wait for event on %s:%d",
+                           pin->chip->path, pin->pin_no);
+      goto error_out;
+    }
+
+    struct gpiod_line_event event;
+    if (ret > 0 && gpiod_line_event_read(pin->private, &event)) {
+      dd_errno = dd_errnof(errno, "Unable to read event on %s:%d",
+                           pin->chip->path, pin->pin_no);
+      goto error_out;
+    }
+  }
+
+  return 0;
+
+error_out:
+  return dd_errno;
+}
+
 int dd_gpio_read_pin(struct dd_GpioPin *pin, struct dd_Gpio *gpio) {
   int ret = gpiod_line_get_value(pin->private);
   if (ret < 0) {
@@ -14,6 +14,7 @@ struct dd_GpioPin {
   struct dd_GpioChip *chip;
   void *private;
   bool is_out;
+  bool has_events;
   int pin_no;
 };
 
@@ -29,6 +30,17 @@ dd_error_t dd_gpio_add_pin(const char *chip_path, int pin_no,
                            struct dd_GpioPin **out, struct dd_Gpio *gpio);
 dd_error_t dd_gpio_set_pin_output(struct dd_GpioPin *pin, bool is_active_high);
 dd_error_t dd_gpio_set_pin_input(struct dd_GpioPin *pin);
+/**
+   @brief Request pin as input which reports edge events, so
+          `dd_gpio_wait_pin` can sleep until the value changes.
+*/
+dd_error_t dd_gpio_set_pin_input_events(struct dd_GpioPin *pin);
+/**
+   @brief Block until pin reads `value`, fails with ETIMEDOUT after
+          `timeout_ms`.
+*/
+dd_error_t dd_gpio_wait_pin(int value, int timeout_ms, struct dd_GpioPin *pin,
+                            struct dd_Gpio *gpio);
 int dd_gpio_read_pin(struct dd_GpioPin *pin, struct dd_Gpio *gpio);
 dd_error_t dd_gpio_set_pin(int value, struct dd_GpioPin *pin,
                            struct dd_Gpio *gpio);
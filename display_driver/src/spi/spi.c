@@ -5,6 +5,8 @@
 #include <linux/spi/spidev.h>
 #include <linux/types.h>
 #include <stdint.h>
+#include <stdio.h>
+#include <string.h>
 #include <sys/ioctl.h>
 #include <unistd.h>
 
@@ -18,8 +20,11 @@ struct dd_SpiPrivate {
   struct spi_ioc_transfer transfer;
   uint32_t bus_mode;
   uint8_t bit_order;
+  uint32_t max_transfer;
 };
 
+static uint32_t dd_spi_read_bufsiz(void);
+
 dd_error_t dd_spi_init(const char *path, struct dd_Spi *spi) {
   int fd = dd_io_open(path, O_RDWR);
   if (fd < 0) {
@@ -64,6 +69,8 @@ dd_error_t dd_spi_init(const char *path, struct dd_Spi *spi) {
     goto error_spi_cleanup;
   }
 
+  spi_priv->max_transfer = dd_spi_read_bufsiz();
+
   return 0;
 
 error_spi_cleanup:
@@ -89,15 +96,137 @@ void dd_spi_destroy(struct dd_Spi *spi) {
   *spi = (struct dd_Spi){0};
 }
 
+static dd_error_t dd_spi_send_message(struct spi_ioc_transfer *transfers,
+                                      int transfers_len, struct dd_Spi *spi);
+
+/**
+   Module parameter is readable only when spidev is loaded as a module, if
+   it is built in or sysfs is not there we assume the kernel default.
+*/
+static uint32_t dd_spi_read_bufsiz(void) {
+  unsigned long bufsiz = 0;
+  FILE *file = fopen(DD_SPI_BUFSIZ_PATH, "re");
+  if (!file) {
+    return DD_SPI_BUF_LEN;
+  }
+
+  if (fscanf(file, "%lu", &bufsiz) != 1 || bufsiz == 0 ||
+      bufsiz > UINT32_MAX) {
+    bufsiz = DD_SPI_BUF_LEN;
+  }
+
+  fclose(file);
+  return bufsiz;
+}
+
+uint32_t dd_spi_max_transfer(struct dd_Spi *spi) {
+  struct dd_SpiPrivate *spi_priv = spi->private;
+  return spi_priv->max_transfer;
+}
+
 dd_error_t dd_spi_send_bytes(uint8_t *bytes, uint32_t len, struct dd_Spi *spi) {
+  dd_errno = dd_spi_send_segments(
+      &(struct dd_SpiSegment){.data = bytes, .len = len}, 1, spi);
+  DD_TRY(dd_errno);
+
+  return 0;
+
+error_out:
+  return dd_errno;
+}
+
+dd_error_t dd_spi_send_repeated(uint8_t byte, uint32_t len,
+                                struct dd_Spi *spi) {
   struct dd_SpiPrivate *spi_priv = spi->private;
+  struct dd_SpiSegment segments[DD_SPI_MAX_SEGMENTS];
+  if (len == 0) {
+    return 0;
+  }
+
+  uint32_t fill_len =
+      len < spi_priv->max_transfer ? len : spi_priv->max_transfer;
+  uint8_t *fill = dd_malloc(fill_len);
+  memset(fill, byte, fill_len);
+
+  while (len > 0) {
+    int segments_len = 0;
+    for (; segments_len < DD_SPI_MAX_SEGMENTS && len > 0; segments_len++) {
+      uint32_t segment_len = len < fill_len ? len : fill_len;
+      segments[segments_len] =
+          (struct dd_SpiSegment){.data = fill, .len = segment_len};
+      len -= segment_len;
+    }
 
-  spi_priv->transfer.len = len;
-  spi_priv->transfer.tx_buf = (unsigned long)bytes;
-  spi_priv->transfer.rx_buf = 0;
+    dd_errno = dd_spi_send_segments(segments, segments_len, spi);
+    DD_TRY_CATCH(dd_errno, error_fill_cleanup);
+  }
+
+  dd_free(fill);
+
+  return 0;
+
+error_fill_cleanup:
+  dd_free(fill);
+  return dd_errno;
+}
+
+/**
+   Transfers of one message are sent with chip select held, so the device
+   sees the same stream as with one transfer per byte, without a syscall
+   per byte.
+*/
+dd_error_t dd_spi_send_segments(const struct dd_SpiSegment *segments,
+                                int segments_len, struct dd_Spi *spi) {
+  struct dd_SpiPrivate *spi_priv = spi->private;
+  struct spi_ioc_transfer transfers[DD_SPI_MAX_SEGMENTS];
+  uint32_t max_len = spi_priv->max_transfer;
+  int transfers_len = 0;
+  uint32_t message_len = 0;
+
+  for (int i = 0; i < segments_len; i++) {
+    const uint8_t *data = segments[i].data;
+    uint32_t left = segments[i].len;
+
+    while (left > 0) {
+      if (transfers_len == DD_SPI_MAX_SEGMENTS || message_len == max_len) {
+        dd_errno = dd_spi_send_message(transfers, transfers_len, spi);
+        DD_TRY(dd_errno);
+        transfers_len = 0;
+        message_len = 0;
+      }
+
+      uint32_t len = max_len - message_len;
+      len = left < len ? left : len;
+      transfers[transfers_len++] = (struct spi_ioc_transfer){
+          .tx_buf = (unsigned long)data,
+          .len = len,
+          .speed_hz = spi_priv->transfer.speed_hz,
+          .bits_per_word = spi_priv->transfer.bits_per_word,
+      };
+      message_len += len;
+      data += len;
+      left -= len;
+    }
+  }
+
+  if (transfers_len > 0) {
+    dd_errno = dd_spi_send_message(transfers, transfers_len, spi);
+    DD_TRY(dd_errno);
+  }
+
+  return 0;
+
+error_out:
+  return dd_errno;
+}
+
+static dd_error_t dd_spi_send_message(struct spi_ioc_transfer *transfers,
+                                      int transfers_len, struct dd_Spi *spi) {
+  struct dd_SpiPrivate *spi_priv = spi->private;
 
   // ioctl Operation, transmission of data
-  if (dd_io_ioctl(spi_priv->fd, SPI_IOC_MESSAGE(1), &spi_priv->transfer) < 1) {
+  if (dd_io_ioctl(spi_priv->fd, SPI_IOC_MESSAGE(transfers_len), transfers) <
+      1) {
     dd_errno = dd_errnos(errno, "Cannot send SPI bytes");
     goto error_out;
   }
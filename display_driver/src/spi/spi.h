@@ -4,14 +4,48 @@
 #include <stdint.h>
 
 #include "display_driver.h"
+
+/**
+   spidev accepts messages of at most `bufsiz` bytes in total. The limit is
+   read from the module parameter on init, this is the kernel default used
+   when it cannot be read.
+*/
+#define DD_SPI_BUF_LEN 4096
+#define DD_SPI_BUFSIZ_PATH "/sys/module/spidev/parameters/bufsiz"
+#define DD_SPI_MAX_SEGMENTS 16
+
 struct dd_Spi {
   const char *path;
   void *private;
 };
 
+struct dd_SpiSegment {
+  const uint8_t *data;
+  uint32_t len;
+};
+
 dd_error_t dd_spi_init(const char *path, struct dd_Spi *spi);
 void dd_spi_destroy(struct dd_Spi *spi);
 dd_error_t dd_spi_send_byte(uint8_t byte, struct dd_Spi *spi);
+/**
+   @brief Max number of bytes spidev accepts in one message.
+*/
+uint32_t dd_spi_max_transfer(struct dd_Spi *spi);
+/**
+   @brief Send buffer of any size, split into as few ioctls as spidev allows.
+*/
 dd_error_t dd_spi_send_bytes(uint8_t *bytes, uint32_t len, struct dd_Spi *spi);
+/**
+   @brief Send the same byte `len` times, e.g. to clear the panel memory.
+*/
+dd_error_t dd_spi_send_repeated(uint8_t byte, uint32_t len,
+                                struct dd_Spi *spi);
+/**
+   @brief Send several buffers as one stream. Up to `DD_SPI_MAX_SEGMENTS`
+   segments are submitted as transfers of a single ioctl, segments which do
+   not fit into one message are split.
+*/
+dd_error_t dd_spi_send_segments(const struct dd_SpiSegment *segments,
+                                int segments_len, struct dd_Spi *spi);
 
 #endif // DISPLAY_DRIVER_SPI_H
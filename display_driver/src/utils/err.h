@@ -207,6 +207,22 @@ static inline void dd_error_add_frame(dd_error_t err, struct dd_EFrame *frame) {
   err->eframes[err->eframes_len++] = *frame;
 }
 
+/**
+ * Copy error object. Message of dd_ErrorType_FSTR is kept in `dst`, so the
+ * copy outlives `src`, e.g. error of another thread.
+ */
+static inline dd_error_t dd_error_copy(struct dd_Error *dst,
+                                       const struct dd_Error *src) {
+  *dst = *src;
+#ifndef DD_ERROR_OPTIMIZE
+  if (src->type == dd_ErrorType_FSTR) {
+    dst->msg = dst->_msg_buf;
+  }
+#endif
+
+  return dst;
+}
+
 #ifndef DD_ERROR_OPTIMIZE
 #define dd_error_wrap(err)                                                     \
   ({                                                                           \
@@ -266,4 +282,17 @@ _Thread_local extern struct dd_Error dd_hidden_errno;
 
 #define DD_TRY(err) DD_TRY_CATCH(err, error_out)
 
+/**
+   Run `cleanup` of a failed operation and keep the error of the operation in
+   `dd_errno`. Cleanup would overwrite it with its own result, even with 0.
+*/
+#define DD_CLEANUP(cleanup)                                                    \
+  do {                                                                         \
+    dd_error_t _dd_err = dd_errno;                                             \
+    struct dd_Error _dd_saved = *_dd_err;                                      \
+    (void)(cleanup);                                                           \
+    *_dd_err = _dd_saved;                                                      \
+    dd_errno = _dd_err;                                                        \
+  } while (0)
+
 #endif
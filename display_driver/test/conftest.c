@@ -1,9 +1,13 @@
 #define _GNU_SOURCE
 #include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdarg.h>
+#include <time.h>
+#include <gpiod.h>
+#include <linux/spi/spidev.h>
 
 #include "utils/mem.h"
 
@@ -117,6 +121,26 @@ int __wrap_gpiod_line_request_input(struct gpiod_line *line,
   return 0;
 }
 
+bool enable_gpiod_line_request_both_edges_events_mock = false;
+int gpiod_line_request_both_edges_events_mock_called = 0;
+int __real_gpiod_line_request_both_edges_events(struct gpiod_line *line,
+                                                const char *consumer);
+int __wrap_gpiod_line_request_both_edges_events(struct gpiod_line *line,
+                                                const char *consumer) {
+  if (!enable_gpiod_line_request_both_edges_events_mock) {
+    return __real_gpiod_line_request_both_edges_events(line, consumer);
+  }
+
+  gpiod_line_request_both_edges_events_mock_called++;
+  printf("%s mocked\n", __func__);
+
+  if (line) {
+    line->requested_out = false;
+  }
+
+  return 0;
+}
+
 bool enable_gpiod_line_release_mock = false;
 int gpiod_line_release_mock_called = 0;
 void __real_gpiod_line_release(struct gpiod_line *line);
@@ -167,6 +191,47 @@ int __wrap_gpiod_line_get_value(struct gpiod_line *line) {
 }
 
 
+// Event wait reports an edge and line reads `gpiod_line_event_mock_value`
+// afterwards, return 0 to simulate timeout.
+bool enable_gpiod_line_event_wait_mock = false;
+int gpiod_line_event_wait_mock_called = 0;
+int gpiod_line_event_wait_mock_return = 1;
+int gpiod_line_event_mock_value = 1;
+int __real_gpiod_line_event_wait(struct gpiod_line *line,
+                                 const struct timespec *timeout);
+int __wrap_gpiod_line_event_wait(struct gpiod_line *line,
+                                 const struct timespec *timeout) {
+  if (!enable_gpiod_line_event_wait_mock) {
+    return __real_gpiod_line_event_wait(line, timeout);
+  }
+
+  gpiod_line_event_wait_mock_called++;
+  printf("%s mocked\n", __func__);
+
+  if (gpiod_line_event_wait_mock_return == 1) {
+    gpiod_line_get_value_mock_return = gpiod_line_event_mock_value;
+  }
+
+  return gpiod_line_event_wait_mock_return;
+}
+
+bool enable_gpiod_line_event_read_mock = false;
+int gpiod_line_event_read_mock_called = 0;
+int __real_gpiod_line_event_read(struct gpiod_line *line,
+                                 struct gpiod_line_event *event);
+int __wrap_gpiod_line_event_read(struct gpiod_line *line,
+                                 struct gpiod_line_event *event) {
+  if (!enable_gpiod_line_event_read_mock) {
+    return __real_gpiod_line_event_read(line, event);
+  }
+
+  gpiod_line_event_read_mock_called++;
+  printf("%s mocked\n", __func__);
+
+  *event = (struct gpiod_line_event){.event_type = GPIOD_LINE_EVENT_RISING_EDGE};
+  return 0;
+}
+
 bool enable_gpiod_line_set_value_mock = false;
 int gpiod_line_set_value_mock_called = 0;
 int __real_gpiod_line_set_value(struct gpiod_line *line, int value);
@@ -215,7 +280,13 @@ int __wrap_dd_io_close(int fd) {
 bool enable_ioctl_mock = false;
 int ioctl_mock_called = 0;
 int ioctl_mock_fail_after = -1;   // -1 => never fail
+int ioctl_mock_fail_count = -1;   // -1 => fail every call after
 int ioctl_mock_errno = EINVAL;
+int spi_mock_messages = 0;
+int spi_mock_transfers = 0;
+int spi_mock_max_message_len = 0;
+long spi_mock_bytes = 0;
+int spi_mock_last_byte = -1;
 int __real_dd_io_ioctl(int fd, unsigned long req, void *arg);
 int __wrap_dd_io_ioctl(int fd, unsigned long req, void *arg) {
   (void)fd; (void)req;
@@ -227,12 +298,38 @@ int __wrap_dd_io_ioctl(int fd, unsigned long req, void *arg) {
   ioctl_mock_called++;
   printf("%s mocked\n", __func__);
 
-  if (ioctl_mock_fail_after >= 0 && ioctl_mock_called > ioctl_mock_fail_after) {
+  if (ioctl_mock_fail_after >= 0 && ioctl_mock_called > ioctl_mock_fail_after &&
+      (ioctl_mock_fail_count < 0 ||
+       ioctl_mock_called <= ioctl_mock_fail_after + ioctl_mock_fail_count)) {
     errno = ioctl_mock_errno;
     return -1;
   }
 
-  // Behave like success for config + SPI_IOC_MESSAGE
+  if (_IOC_TYPE(req) == SPI_IOC_MAGIC && _IOC_NR(req) == 0 &&
+      _IOC_DIR(req) == _IOC_WRITE) {
+    // SPI_IOC_MESSAGE(n), returns number of bytes transferred
+    struct spi_ioc_transfer *transfers = arg;
+    int transfers_len = _IOC_SIZE(req) / sizeof(struct spi_ioc_transfer);
+    int message_len = 0;
+    for (int i = 0; i < transfers_len; i++) {
+      message_len += transfers[i].len;
+    }
+    struct spi_ioc_transfer *last = &transfers[transfers_len - 1];
+    if (last->len > 0 && last->tx_buf) {
+      spi_mock_last_byte =
+          ((unsigned char *)(uintptr_t)last->tx_buf)[last->len - 1];
+    }
+
+    spi_mock_messages++;
+    spi_mock_transfers += transfers_len;
+    spi_mock_bytes += message_len;
+    if (message_len > spi_mock_max_message_len) {
+      spi_mock_max_message_len = message_len;
+    }
+    return message_len;
+  }
+
+  // Behave like success for config
   return 0;
 }
 
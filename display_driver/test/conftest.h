@@ -18,6 +18,17 @@ extern int gpiod_line_request_output_mock_called;
 extern bool enable_gpiod_line_request_input_mock;
 extern int gpiod_line_request_input_mock_called;
 
+extern bool enable_gpiod_line_request_both_edges_events_mock;
+extern int gpiod_line_request_both_edges_events_mock_called;
+
+extern bool enable_gpiod_line_event_wait_mock;
+extern int gpiod_line_event_wait_mock_called;
+extern int gpiod_line_event_wait_mock_return;
+extern int gpiod_line_event_mock_value;
+
+extern bool enable_gpiod_line_event_read_mock;
+extern int gpiod_line_event_read_mock_called;
+
 extern bool enable_gpiod_line_release_mock;
 extern int gpiod_line_release_mock_called;
 
@@ -41,7 +52,13 @@ extern int close_mock_called;
 extern bool enable_ioctl_mock;
 extern int ioctl_mock_called;
 extern int ioctl_mock_fail_after; 
+extern int ioctl_mock_fail_count;
 extern int ioctl_mock_errno;
+extern int spi_mock_messages;
+extern int spi_mock_transfers;
+extern int spi_mock_max_message_len;
+extern long spi_mock_bytes;
+extern int spi_mock_last_byte;
 
 extern bool enable_dd_sleep_ms_mock;
 extern int dd_sleep_ms_mock_called;
@@ -17,6 +17,10 @@ static void enable_all_gpio_mocks(void) {
   enable_gpiod_chip_get_line_mock = true;
   enable_gpiod_line_request_output_mock = true;
   enable_gpiod_line_request_input_mock = true;
+  enable_gpiod_line_request_both_edges_events_mock = true;
+  enable_gpiod_line_get_value_mock = true;
+  enable_gpiod_line_event_wait_mock = true;
+  enable_gpiod_line_event_read_mock = true;
   enable_gpiod_line_release_mock = true;
 }
 
@@ -26,6 +30,13 @@ static void reset_all_mock_counters(void) {
   gpiod_chip_get_line_mock_called = 0;
   gpiod_line_request_output_mock_called = 0;
   gpiod_line_request_input_mock_called = 0;
+  gpiod_line_request_both_edges_events_mock_called = 0;
+  gpiod_line_get_value_mock_called = 0;
+  gpiod_line_event_wait_mock_called = 0;
+  gpiod_line_event_read_mock_called = 0;
+  gpiod_line_get_value_mock_return = 0;
+  gpiod_line_event_wait_mock_return = 1;
+  gpiod_line_event_mock_value = 1;
   gpiod_line_release_mock_called = 0;
 }
 
@@ -112,6 +123,49 @@ void test_dd_gpio_set_pin_input_calls_gpiod_request_input_and_sets_is_out_false(
   TEST_ASSERT_FALSE(pin->is_out);
 }
 
+void test_dd_gpio_set_pin_input_events_requests_both_edges(void) {
+  struct dd_GpioPin *pin = NULL;
+  TEST_ASSERT_EQUAL(0, dd_gpio_add_pin("/dev/gpiochip0", 3, &pin, &gpio));
+
+  TEST_ASSERT_EQUAL(0, dd_gpio_set_pin_input_events(pin));
+
+  TEST_ASSERT_EQUAL(1, gpiod_line_request_both_edges_events_mock_called);
+  TEST_ASSERT_FALSE(pin->is_out);
+  TEST_ASSERT_TRUE(pin->has_events);
+}
+
+void test_dd_gpio_wait_pin_returns_without_waiting_when_value_matches(void) {
+  struct dd_GpioPin *pin = NULL;
+  TEST_ASSERT_EQUAL(0, dd_gpio_add_pin("/dev/gpiochip0", 3, &pin, &gpio));
+  TEST_ASSERT_EQUAL(0, dd_gpio_set_pin_input_events(pin));
+  gpiod_line_get_value_mock_return = 1;
+
+  TEST_ASSERT_EQUAL(0, dd_gpio_wait_pin(1, 1000, pin, &gpio));
+  TEST_ASSERT_EQUAL(0, gpiod_line_event_wait_mock_called);
+}
+
+void test_dd_gpio_wait_pin_wakes_up_on_edge_event(void) {
+  struct dd_GpioPin *pin = NULL;
+  TEST_ASSERT_EQUAL(0, dd_gpio_add_pin("/dev/gpiochip0", 3, &pin, &gpio));
+  TEST_ASSERT_EQUAL(0, dd_gpio_set_pin_input_events(pin));
+
+  TEST_ASSERT_EQUAL(0, dd_gpio_wait_pin(1, 1000, pin, &gpio));
+  TEST_ASSERT_EQUAL(1, gpiod_line_event_wait_mock_called);
+  TEST_ASSERT_EQUAL(1, gpiod_line_event_read_mock_called);
+  TEST_ASSERT_EQUAL(2, gpiod_line_get_value_mock_called);
+}
+
+void test_dd_gpio_wait_pin_times_out(void) {
+  struct dd_GpioPin *pin = NULL;
+  TEST_ASSERT_EQUAL(0, dd_gpio_add_pin("/dev/gpiochip0", 3, &pin, &gpio));
+  TEST_ASSERT_EQUAL(0, dd_gpio_set_pin_input_events(pin));
+  gpiod_line_event_wait_mock_return = 0;
+
+  dd_error_t err = dd_gpio_wait_pin(1, 20, pin, &gpio);
+  TEST_ASSERT_NOT_EQUAL(0, err);
+  TEST_ASSERT_EQUAL(ETIMEDOUT, dd_error_get_code(err));
+}
+
 void test_dd_gpio_pin_destroy_releases_line_and_removes_pin(void) {
   struct dd_GpioPin *p1 = NULL;
   struct dd_GpioPin *p2 = NULL;
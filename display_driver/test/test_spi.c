@@ -0,0 +1,96 @@
+#include <unity.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <errno.h>
+
+#include "spi/spi.h"
+#include "utils/err.h"
+#include "conftest.h"
+
+/* ============================================================
+ * Fixture
+ * ============================================================ */
+static struct dd_Spi spi;
+
+void setUp(void) {
+  dd_errno = 0;
+
+  enable_open_mock = true;
+  enable_close_mock = true;
+  enable_ioctl_mock = true;
+  open_mock_return = 42;
+  ioctl_mock_fail_after = -1;
+  ioctl_mock_errno = EINVAL;
+
+  TEST_ASSERT_EQUAL(0, dd_spi_init("/dev/spidev0.0", &spi));
+
+  ioctl_mock_called = 0;
+  spi_mock_messages = 0;
+  spi_mock_transfers = 0;
+  spi_mock_max_message_len = 0;
+  spi_mock_bytes = 0;
+}
+
+void tearDown(void) {
+  dd_spi_destroy(&spi);
+}
+
+/* ============================================================
+ * Tests
+ * ============================================================ */
+void test_max_transfer_is_known_after_init(void) {
+  TEST_ASSERT_GREATER_THAN(0, dd_spi_max_transfer(&spi));
+}
+
+void test_send_bytes_small_buffer_is_one_message(void) {
+  uint8_t buf[100] = {0};
+
+  TEST_ASSERT_EQUAL(0, dd_spi_send_bytes(buf, sizeof(buf), &spi));
+  TEST_ASSERT_EQUAL(1, spi_mock_messages);
+  TEST_ASSERT_EQUAL(100, spi_mock_bytes);
+}
+
+void test_send_bytes_splits_at_spidev_buffer_size(void) {
+  static uint8_t buf[10000];
+
+  uint32_t max = dd_spi_max_transfer(&spi);
+
+  TEST_ASSERT_EQUAL(0, dd_spi_send_bytes(buf, sizeof(buf), &spi));
+  TEST_ASSERT_EQUAL((sizeof(buf) + max - 1) / max, spi_mock_messages);
+  TEST_ASSERT_EQUAL(10000, spi_mock_bytes);
+  TEST_ASSERT_LESS_OR_EQUAL(max, spi_mock_max_message_len);
+}
+
+void test_send_repeated_sends_whole_frame_in_few_messages(void) {
+  uint32_t max = dd_spi_max_transfer(&spi);
+
+  TEST_ASSERT_EQUAL(0, dd_spi_send_repeated(0xFF, 480 * 100, &spi));
+  TEST_ASSERT_EQUAL(48000, spi_mock_bytes);
+  TEST_ASSERT_EQUAL((48000 + max - 1) / max, spi_mock_messages);
+  TEST_ASSERT_LESS_OR_EQUAL(max, spi_mock_max_message_len);
+}
+
+void test_send_segments_packs_small_segments_into_one_message(void) {
+  uint8_t a[] = {0x01, 0x02};
+  uint8_t b[] = {0x03};
+  uint8_t c[] = {0x04, 0x05, 0x06};
+  struct dd_SpiSegment segments[] = {
+      {.data = a, .len = sizeof(a)},
+      {.data = b, .len = sizeof(b)},
+      {.data = c, .len = sizeof(c)},
+  };
+
+  TEST_ASSERT_EQUAL(0, dd_spi_send_segments(segments, 3, &spi));
+  TEST_ASSERT_EQUAL(1, spi_mock_messages);
+  TEST_ASSERT_EQUAL(3, spi_mock_transfers);
+  TEST_ASSERT_EQUAL(6, spi_mock_bytes);
+}
+
+void test_send_returns_error_when_ioctl_fails(void) {
+  uint32_t max = dd_spi_max_transfer(&spi);
+  ioctl_mock_fail_after = 1;
+
+  TEST_ASSERT_NOT_EQUAL(0, dd_spi_send_repeated(0x00, max * 3, &spi));
+  TEST_ASSERT_EQUAL(2, ioctl_mock_called);
+  TEST_ASSERT_EQUAL(max, spi_mock_bytes);
+}
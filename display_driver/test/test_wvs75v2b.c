@@ -1,7 +1,10 @@
 #include <errno.h>
+#include <poll.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <threads.h>
+#include <unistd.h>
 #include <unity.h>
 
 #include "conftest.h"
@@ -32,6 +35,9 @@ void setUp(void) {
   enable_gpiod_line_request_output_mock = true;
   enable_gpiod_line_request_output_flags_mock = true;
   enable_gpiod_line_request_input_mock = true;
+  enable_gpiod_line_request_both_edges_events_mock = true;
+  enable_gpiod_line_event_wait_mock = true;
+  enable_gpiod_line_event_read_mock = true;
   enable_gpiod_line_release_mock = true;
   enable_gpiod_line_get_value_mock = true;
   enable_gpiod_line_set_value_mock = true;
@@ -47,6 +53,9 @@ void setUp(void) {
   gpiod_line_request_output_mock_called = 0;
   gpiod_line_request_output_flags_mock_called = 0;
   gpiod_line_request_input_mock_called = 0;
+  gpiod_line_request_both_edges_events_mock_called = 0;
+  gpiod_line_event_wait_mock_called = 0;
+  gpiod_line_event_read_mock_called = 0;
   gpiod_line_release_mock_called = 0;
   gpiod_line_get_value_mock_called = 0;
   gpiod_line_set_value_mock_called = 0;
@@ -55,7 +64,9 @@ void setUp(void) {
   close_mock_called = 0;
   ioctl_mock_called = 0;
   ioctl_mock_fail_after = -1;
+  ioctl_mock_fail_count = -1;
   ioctl_mock_errno = EINVAL;
+  spi_mock_last_byte = -1;
 
   open_mock_return = 42;
 
@@ -64,6 +75,8 @@ void setUp(void) {
   // Make busy-wait finish immediately:
   // driver uses enum value 1 for IDLE :contentReference[oaicite:0]{index=0}
   gpiod_line_get_value_mock_return = 1;
+  gpiod_line_event_wait_mock_return = 1;
+  gpiod_line_event_mock_value = 1;
 }
 
 void tearDown(void) {
@@ -88,7 +101,8 @@ void test_init_calls_probe_and_sets_up_gpio_and_spi(void) {
   TEST_ASSERT_EQUAL(4, gpiod_chip_get_line_mock_called); // dc,rst,bsy,pwr
   TEST_ASSERT_EQUAL(3,
                     gpiod_line_request_output_flags_mock_called); // dc,rst,pwr
-  TEST_ASSERT_EQUAL(1, gpiod_line_request_input_mock_called);     // bsy
+  TEST_ASSERT_EQUAL(1,
+                    gpiod_line_request_both_edges_events_mock_called); // bsy
   TEST_ASSERT_TRUE(open_mock_called >= 1);
   TEST_ASSERT_TRUE(ioctl_mock_called >= 1);
 }
@@ -115,6 +129,9 @@ void test_clear_uses_public_api_and_toggles_pins_and_spi(void) {
 
   // SPI bytes go through ioctl(SPI_IOC_MESSAGE) in dd_spi_send_bytes
   TEST_ASSERT_TRUE(ioctl_mock_called > prev_ioc);
+
+  // Both transmissions are sent in spidev sized messages, not byte by byte
+  TEST_ASSERT_TRUE(ioctl_mock_called - prev_ioc < 100);
 }
 
 void test_init_fails_when_spidev_open_fails(void) {
@@ -140,3 +157,194 @@ void test_destroy_releases_gpio_lines_and_chip_close(void) {
   TEST_ASSERT_EQUAL(4, gpiod_line_release_mock_called);
   TEST_ASSERT_EQUAL(1, gpiod_chip_close_mock_called);
 }
+
+void test_session_skips_power_on_between_updates(void) {
+  struct dd_Wvs75V2bConfig cfg = mk_cfg(false);
+  TEST_ASSERT_EQUAL(
+      0, dd_display_driver_init(&g_dd, dd_DisplayDriverEnum_Wvs7in5V2b, &cfg));
+  TEST_ASSERT_EQUAL(0, dd_display_driver_session_open(g_dd, 0));
+
+  int prev_sleep = dd_sleep_ms_mock_called;
+  TEST_ASSERT_EQUAL(0, dd_display_driver_clear(g_dd, true));
+  int first_sleeps = dd_sleep_ms_mock_called - prev_sleep;
+
+  prev_sleep = dd_sleep_ms_mock_called;
+  TEST_ASSERT_EQUAL(0, dd_display_driver_clear(g_dd, true));
+  int second_sleeps = dd_sleep_ms_mock_called - prev_sleep;
+
+  // No power on, reset and deep sleep around the second update
+  TEST_ASSERT_TRUE(second_sleeps < first_sleeps);
+
+  // Closing session puts panel into deep sleep
+  int prev_ioc = ioctl_mock_called;
+  TEST_ASSERT_EQUAL(0, dd_display_driver_session_close(g_dd));
+  TEST_ASSERT_TRUE(ioctl_mock_called > prev_ioc);
+}
+
+void test_session_cannot_be_opened_twice(void) {
+  struct dd_Wvs75V2bConfig cfg = mk_cfg(false);
+  TEST_ASSERT_EQUAL(
+      0, dd_display_driver_init(&g_dd, dd_DisplayDriverEnum_Wvs7in5V2b, &cfg));
+
+  TEST_ASSERT_EQUAL(0, dd_display_driver_session_open(g_dd, 0));
+  TEST_ASSERT_NOT_EQUAL(0, dd_display_driver_session_open(g_dd, 0));
+  TEST_ASSERT_EQUAL(0, dd_display_driver_session_close(g_dd));
+}
+
+void test_session_idle_timeout_puts_panel_to_sleep(void) {
+  struct dd_Wvs75V2bConfig cfg = mk_cfg(false);
+  TEST_ASSERT_EQUAL(
+      0, dd_display_driver_init(&g_dd, dd_DisplayDriverEnum_Wvs7in5V2b, &cfg));
+  TEST_ASSERT_EQUAL(0, dd_display_driver_session_open(g_dd, 10));
+  TEST_ASSERT_EQUAL(0, dd_display_driver_clear(g_dd, true));
+
+  int prev_ioc = ioctl_mock_called;
+  thrd_sleep(&(struct timespec){.tv_nsec = 200 * 1000000L}, NULL);
+  TEST_ASSERT_TRUE(ioctl_mock_called > prev_ioc);
+
+  // Panel already sleeps so close has nothing to send
+  prev_ioc = ioctl_mock_called;
+  TEST_ASSERT_EQUAL(0, dd_display_driver_session_close(g_dd));
+  TEST_ASSERT_EQUAL(prev_ioc, ioctl_mock_called);
+}
+
+void test_session_close_reports_failed_idle_sleep(void) {
+  struct dd_Wvs75V2bConfig cfg = mk_cfg(false);
+  TEST_ASSERT_EQUAL(
+      0, dd_display_driver_init(&g_dd, dd_DisplayDriverEnum_Wvs7in5V2b, &cfg));
+  TEST_ASSERT_EQUAL(0, dd_display_driver_session_open(g_dd, 10));
+  TEST_ASSERT_EQUAL(0, dd_display_driver_clear(g_dd, true));
+
+  ioctl_mock_fail_after = ioctl_mock_called;
+  ioctl_mock_errno = EIO;
+  thrd_sleep(&(struct timespec){.tv_nsec = 200 * 1000000L}, NULL);
+
+  dd_error_t err = dd_display_driver_session_close(g_dd);
+  TEST_ASSERT_NOT_EQUAL(0, err);
+  TEST_ASSERT_EQUAL(EIO, dd_error_get_code(err));
+}
+
+void test_write_reports_busy_timeout(void) {
+  static unsigned char buf[800 * 480 / 8];
+  struct dd_Wvs75V2bConfig cfg = mk_cfg(false);
+  TEST_ASSERT_EQUAL(
+      0, dd_display_driver_init(&g_dd, dd_DisplayDriverEnum_Wvs7in5V2b, &cfg));
+
+  // BUSY never goes idle, reset after the timeout must not hide it
+  gpiod_line_get_value_mock_return = 0;
+  gpiod_line_event_wait_mock_return = 0;
+
+  dd_error_t err = dd_display_driver_write(g_dd, buf, sizeof(buf));
+  TEST_ASSERT_NOT_EQUAL(0, err);
+  TEST_ASSERT_EQUAL(ETIMEDOUT, dd_error_get_code(err));
+}
+
+void test_clear_reports_spi_error(void) {
+  struct dd_Wvs75V2bConfig cfg = mk_cfg(false);
+  TEST_ASSERT_EQUAL(
+      0, dd_display_driver_init(&g_dd, dd_DisplayDriverEnum_Wvs7in5V2b, &cfg));
+
+  // First command of power on fails, following reset must not hide it
+  ioctl_mock_fail_after = ioctl_mock_called;
+  ioctl_mock_errno = EIO;
+
+  dd_error_t err = dd_display_driver_clear(g_dd, true);
+  TEST_ASSERT_NOT_EQUAL(0, err);
+  TEST_ASSERT_EQUAL(EIO, dd_error_get_code(err));
+}
+
+void test_session_powers_on_again_after_failed_update(void) {
+  struct dd_Wvs75V2bConfig cfg = mk_cfg(false);
+  TEST_ASSERT_EQUAL(
+      0, dd_display_driver_init(&g_dd, dd_DisplayDriverEnum_Wvs7in5V2b, &cfg));
+  TEST_ASSERT_EQUAL(0, dd_display_driver_session_open(g_dd, 0));
+  TEST_ASSERT_EQUAL(0, dd_display_driver_clear(g_dd, true));
+
+  int prev_sleep = dd_sleep_ms_mock_called;
+  TEST_ASSERT_EQUAL(0, dd_display_driver_clear(g_dd, true));
+  int awake_sleeps = dd_sleep_ms_mock_called - prev_sleep;
+
+  // Failed update resets the controller and still puts it to deep sleep
+  ioctl_mock_fail_after = ioctl_mock_called;
+  ioctl_mock_fail_count = 1;
+  TEST_ASSERT_NOT_EQUAL(0, dd_display_driver_clear(g_dd, true));
+  TEST_ASSERT_EQUAL(0xA5, spi_mock_last_byte); // DEEP_SLEEP check code
+  ioctl_mock_fail_after = -1;
+
+  prev_sleep = dd_sleep_ms_mock_called;
+  TEST_ASSERT_EQUAL(0, dd_display_driver_clear(g_dd, true));
+  TEST_ASSERT_TRUE(dd_sleep_ms_mock_called - prev_sleep > awake_sleeps);
+
+  TEST_ASSERT_EQUAL(0, dd_display_driver_session_close(g_dd));
+}
+
+struct AsyncResult {
+  int called;
+  int code;
+};
+
+static void async_done_cb(dd_error_t err, void *data) {
+  struct AsyncResult *result = data;
+  result->called++;
+  result->code = err ? dd_error_get_code(err) : 0;
+}
+
+void test_submit_async_notifies_callback_and_event_fd(void) {
+  struct dd_Wvs75V2bConfig cfg = mk_cfg(false);
+  TEST_ASSERT_EQUAL(
+      0, dd_display_driver_init(&g_dd, dd_DisplayDriverEnum_Wvs7in5V2b, &cfg));
+
+  int fd = dd_display_driver_get_event_fd(g_dd);
+  TEST_ASSERT_TRUE(fd >= 0);
+
+  static unsigned char buf[800 / 8 * 480];
+  struct AsyncResult result = {0};
+  struct dd_DisplayDriverWrite write = {
+      .type = dd_DisplayDriverWriteEnum_FULL,
+      .buf = buf,
+      .buf_len = sizeof(buf),
+  };
+  TEST_ASSERT_EQUAL(
+      0, dd_display_driver_submit_async(g_dd, &write, async_done_cb, &result));
+
+  struct pollfd pfd = {.fd = fd, .events = POLLIN};
+  TEST_ASSERT_EQUAL(1, poll(&pfd, 1, 5000));
+
+  uint64_t done = 0;
+  TEST_ASSERT_EQUAL(sizeof(done), read(fd, &done, sizeof(done)));
+  TEST_ASSERT_EQUAL(1, done);
+  TEST_ASSERT_EQUAL(1, result.called);
+  TEST_ASSERT_EQUAL(0, result.code);
+}
+
+void test_submit_async_reports_unsupported_write(void) {
+  struct dd_Wvs75V2bConfig cfg = mk_cfg(false);
+  TEST_ASSERT_EQUAL(
+      0, dd_display_driver_init(&g_dd, dd_DisplayDriverEnum_Wvs7in5V2b, &cfg));
+
+  static unsigned char buf[16];
+  struct AsyncResult result = {0};
+  struct dd_DisplayDriverWrite write = {
+      .type = dd_DisplayDriverWriteEnum_FAST, // V2b has no fast mode
+      .buf = buf,
+      .buf_len = sizeof(buf),
+  };
+  TEST_ASSERT_EQUAL(
+      0, dd_display_driver_submit_async(g_dd, &write, async_done_cb, &result));
+
+  struct pollfd pfd = {.fd = dd_display_driver_get_event_fd(g_dd),
+                       .events = POLLIN};
+  TEST_ASSERT_EQUAL(1, poll(&pfd, 1, 5000));
+  TEST_ASSERT_EQUAL(1, result.called);
+  TEST_ASSERT_EQUAL(EINVAL, result.code);
+}
+
+void test_submit_async_rejects_null_buffer(void) {
+  struct dd_Wvs75V2bConfig cfg = mk_cfg(false);
+  TEST_ASSERT_EQUAL(
+      0, dd_display_driver_init(&g_dd, dd_DisplayDriverEnum_Wvs7in5V2b, &cfg));
+
+  struct dd_DisplayDriverWrite write = {.type = dd_DisplayDriverWriteEnum_FULL};
+  TEST_ASSERT_NOT_EQUAL(
+      0, dd_display_driver_submit_async(g_dd, &write, NULL, NULL));
+}
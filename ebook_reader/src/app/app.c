@@ -1,4 +1,5 @@
 #include <lvgl.h>
+#include <poll.h>
 
 #include "app/app.h"
 #include "book_settings/book_settings.h"
@@ -9,7 +10,6 @@
 #include "reader/reader.h"
 #include "utils/err.h"
 #include "utils/mem.h"
-#include "utils/time.h"
 
 struct App {
   book_settings_t book_settings;
@@ -24,7 +24,8 @@ err_t app_init(app_t *out) {
   app_t app = *out = mem_malloc(sizeof(struct App));
   *app = (struct App){0};
 
-  event_queue_init(&app->event_queue);
+  err_o = event_queue_init(&app->event_queue);
+  ERR_TRY(err_o);
 
   lv_init();
   err_o = display_init(&app->display);
@@ -88,11 +89,29 @@ void app_destroy(app_t *out) {
   *out = NULL;
 };
 
+/**
+   Loop sleeps until the next LVGL timer, a change in the books directory or
+   the end of the library debounce, whichever comes first.
+*/
 err_t app_main(app_t app) {
+  struct pollfd library_fd = {.events = POLLIN};
+
   while (1) {
     event_queue_step(app->event_queue);
 
+    // Watch is dropped if the books directory disappears.
+    library_fd.fd = library_watch_fd(app->library);
+
     int ms = lv_timer_handler();
-    time_sleep_ms(ms);
+    int watch_ms = library_watch_timeout(app->library);
+    if (watch_ms != -1 && (watch_ms < ms || ms == (int)LV_NO_TIMER_READY)) {
+      ms = watch_ms;
+    }
+
+    poll(&library_fd, 1, ms);
+
+    if (library_watch_step(app->library)) {
+      event_queue_push(app->event_queue, Events_LIBRARY_UPDATED, NULL);
+    }
   }
 };
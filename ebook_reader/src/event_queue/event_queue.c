@@ -1,4 +1,7 @@
+#include <threads.h>
+
 #include "event_queue/event_queue.h"
+#include "utils/err.h"
 #include "utils/log.h"
 #include "utils/mem.h"
 #include "utils/zlist.h"
@@ -17,7 +20,12 @@ struct Subscriber {
   void *data;
 };
 
+/**
+   Events can be pushed from worker threads, lock guards the queue itself.
+   Subscribers are called only from the thread running `event_queue_step`.
+*/
 struct EventQueue {
+  mtx_t lock;
   struct ZList queue;
   struct Subscriber subscribers[EventSubscribers_MAX];
 };
@@ -27,6 +35,14 @@ enum EventSubscribers route_table[Events_MAX][EventSubscribers_MAX] = {
         {
             EventSubscribers_MENU,
         },
+    [Events_LIBRARY_UPDATED] =
+        {
+            EventSubscribers_MENU,
+        },
+    [Events_BOOK_THUMBNAIL_READY] =
+        {
+            EventSubscribers_MENU,
+        },
     [Events_BOOK_OPENED] =
         {
             EventSubscribers_MENU,
@@ -44,6 +60,14 @@ enum EventSubscribers route_table[Events_MAX][EventSubscribers_MAX] = {
         {
             EventSubscribers_READER,
         },
+    [Events_BOOK_PAGE_READY] =
+        {
+            EventSubscribers_READER,
+        },
+    [Events_BOOK_CROP_READY] =
+        {
+            EventSubscribers_READER,
+        },
     [Events_BTN_MENU_CLICKED] =
         {
             EventSubscribers_READER,
@@ -89,9 +113,21 @@ enum EventSubscribers route_table[Events_MAX][EventSubscribers_MAX] = {
 static void event_bus_route_event(event_queue_t queue, event_t event);
 static event_t event_queue_pull(event_queue_t queue);
 
-void event_queue_init(event_queue_t *out) {
+err_t event_queue_init(event_queue_t *out) {
   event_queue_t queue = *out = mem_malloc(sizeof(struct EventQueue));
   *queue = (struct EventQueue){0};
+
+  if (mtx_init(&queue->lock, mtx_plain) != thrd_success) {
+    err_o = err_errnos(ENOMEM, "Cannot create event queue lock");
+    goto error_out;
+  }
+
+  return 0;
+
+error_out:
+  mem_free(queue);
+  *out = NULL;
+  return err_o;
 };
 
 void event_queue_destroy(event_queue_t *out) {
@@ -104,6 +140,7 @@ void event_queue_destroy(event_queue_t *out) {
     mem_deref(event->data);
     mem_free(event);
   }
+  mtx_destroy(&queue->lock);
   mem_free(queue);
   *out = NULL;
 }
@@ -113,7 +150,9 @@ void event_queue_push(event_queue_t queue, enum Events event,
   event_t ev = mem_malloc(sizeof(struct Event));
   *ev = (struct Event){.data = mem_ref(event_data), .event = event};
 
+  mtx_lock(&queue->lock);
   zlist_append(&queue->queue, &ev->next);
+  mtx_unlock(&queue->lock);
 }
 
 void event_queue_step(event_queue_t queue) {
@@ -144,7 +183,9 @@ static void event_bus_route_event(event_queue_t queue, event_t event) {
 }
 
 static event_t event_queue_pull(event_queue_t queue) {
+  mtx_lock(&queue->lock);
   zlist_node_t node = zlist_pop(&queue->queue, 0);
+  mtx_unlock(&queue->lock);
   if (!node) {
     return NULL;
   }
@@ -170,9 +211,13 @@ const char *events_dump(enum Events event) {
   static const char *const dumps[Events_MAX] = {
       [Events_NONE] = "Events_NONE",
       [Events_BOOT_DONE] = "Events_BOOT_DONE",
+      [Events_LIBRARY_UPDATED] = "Events_LIBRARY_UPDATED",
+      [Events_BOOK_THUMBNAIL_READY] = "Events_BOOK_THUMBNAIL_READY",
       [Events_BOOK_OPENED] = "Events_BOOK_OPENED",
       [Events_BOOK_CLOSED] = "Events_BOOK_CLOSED",
       [Events_BOOK_UPDATED] = "Events_BOOK_UPDATED",
+      [Events_BOOK_PAGE_READY] = "Events_BOOK_PAGE_READY",
+      [Events_BOOK_CROP_READY] = "Events_BOOK_CROP_READY",
       [Events_BTN_NEXT_PAGE_CLICKED] = "Events_BTN_NEXT_PAGE_CLICKED",
       [Events_BTN_PREV_PAGE_CLICKED] = "Events_BTN_PREV_PAGE_CLICKED",
       [Events_BTN_MENU_CLICKED] = "Events_BTN_MENU_CLICKED",
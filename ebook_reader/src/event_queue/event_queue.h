@@ -1,16 +1,21 @@
 #ifndef EBOOK_READER_EVENT_QUEUE_H
 #define EBOOK_READER_EVENT_QUEUE_H
 
+#include "utils/err.h"
 #include "utils/mem.h"
 
 enum Events {
   Events_NONE,
   // Global events
   Events_BOOT_DONE,
+  Events_LIBRARY_UPDATED,
+  Events_BOOK_THUMBNAIL_READY,
   // Book events
   Events_BOOK_OPENED,
   Events_BOOK_CLOSED,
   Events_BOOK_UPDATED,
+  Events_BOOK_PAGE_READY,
+  Events_BOOK_CROP_READY,
   // Book settings events
   Events_BOOK_SETTINGS_OPENED,
   Events_BOOK_SETTINGS_CLOSED,
@@ -41,7 +46,7 @@ typedef struct EventQueue *event_queue_t;
 typedef void (*post_event_func_t)(enum Events event, ref_t event_data,
                                   void *sub_data);
 
-void event_queue_init(event_queue_t *out);
+err_t event_queue_init(event_queue_t *out);
 void event_queue_destroy(event_queue_t *out);
 void event_queue_push(event_queue_t queue, enum Events event, ref_t event_data);
 void event_queue_step(event_queue_t queue);
@@ -0,0 +1,369 @@
+#include <libgen.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "library/catalog.h"
+#include "utils/err.h"
+#include "utils/fs.h"
+#include "utils/log.h"
+#include "utils/mem.h"
+
+#define CATALOG_MAGIC "EBKC"
+#define CATALOG_VERSION 3
+
+struct CatalogItem {
+  struct CatalogEntry entry;
+  bool is_seen;
+};
+
+/**
+   Items are sorted by file name, so every lookup done while a directory is
+   scanned is a binary search.
+*/
+struct Catalog {
+  char *path;
+  struct CatalogItem *items;
+  int items_len;
+  int items_size;
+  bool is_dirty;
+};
+
+static void catalog_load(catalog_t catalog);
+static struct CatalogItem *catalog_find_item(catalog_t catalog,
+                                             const char *file_name);
+static int catalog_find_index(catalog_t catalog, const char *file_name,
+                              bool *is_found);
+static struct CatalogItem *catalog_add_item(catalog_t catalog, int index);
+static int catalog_item_cmp(const void *a, const void *b);
+static void catalog_entry_free(struct CatalogEntry *entry);
+static bool catalog_read_str(FILE *file, char **out);
+static bool catalog_write_str(FILE *file, const char *str);
+
+err_t catalog_init(catalog_t *out, const char *path) {
+  catalog_t catalog = *out = mem_malloc(sizeof(struct Catalog));
+  *catalog = (struct Catalog){
+      .path = strdup(path),
+  };
+
+  catalog_load(catalog);
+
+  return 0;
+}
+
+void catalog_destroy(catalog_t *out) {
+  if (mem_is_null_ptr(out)) {
+    return;
+  }
+
+  catalog_t catalog = *out;
+  for (int i = 0; i < catalog->items_len; i++) {
+    catalog_entry_free(&catalog->items[i].entry);
+  }
+
+  mem_free(catalog->items);
+  mem_free(catalog->path);
+  mem_free(catalog);
+  *out = NULL;
+}
+
+void catalog_begin_scan(catalog_t catalog) {
+  for (int i = 0; i < catalog->items_len; i++) {
+    catalog->items[i].is_seen = false;
+  }
+}
+
+void catalog_mark_seen(catalog_t catalog, const char *file_name, int64_t size,
+                       int64_t mtime) {
+  struct CatalogItem *item = catalog_find_item(catalog, file_name);
+  if (!item || item->entry.size != size || item->entry.mtime != mtime) {
+    return;
+  }
+
+  item->is_seen = true;
+}
+
+const struct CatalogEntry *catalog_find(catalog_t catalog,
+                                        const char *file_name, int64_t size,
+                                        int64_t mtime) {
+  struct CatalogItem *item = catalog_find_item(catalog, file_name);
+  if (!item || item->entry.size != size || item->entry.mtime != mtime) {
+    return NULL;
+  }
+
+  return &item->entry;
+}
+
+void catalog_put(catalog_t catalog, const struct CatalogEntry *entry) {
+  bool is_found;
+  struct CatalogItem *item;
+
+  int index = catalog_find_index(catalog, entry->file_name, &is_found);
+  if (is_found) {
+    item = &catalog->items[index];
+    catalog_entry_free(&item->entry);
+  } else {
+    item = catalog_add_item(catalog, index);
+  }
+
+  *item = (struct CatalogItem){
+      .entry =
+          {
+              .file_name = strdup(entry->file_name),
+              .size = entry->size,
+              .mtime = entry->mtime,
+              .title = strdup(entry->title),
+              .pages = entry->pages,
+              .has_content_box = entry->has_content_box,
+              .content_box = entry->content_box,
+          },
+      .is_seen = true,
+  };
+  catalog->is_dirty = true;
+}
+
+void catalog_remove(catalog_t catalog, const char *file_name) {
+  struct CatalogItem *item = catalog_find_item(catalog, file_name);
+  if (!item) {
+    return;
+  }
+
+  catalog_entry_free(&item->entry);
+  memmove(item, item + 1,
+          sizeof(struct CatalogItem) *
+              (catalog->items + --catalog->items_len - item));
+  catalog->is_dirty = true;
+}
+
+void catalog_set_content_box(catalog_t catalog, const char *file_name,
+                             const struct ContentBox *box) {
+  struct CatalogItem *item = catalog_find_item(catalog, file_name);
+  if (!item) {
+    return;
+  }
+
+  item->entry.has_content_box = true;
+  item->entry.content_box = *box;
+  catalog->is_dirty = true;
+}
+
+err_t catalog_save(catalog_t catalog) {
+  char tmp_path[PATH_MAX];
+  char dir[PATH_MAX];
+  int items_len = 0;
+
+  // Drop entries of files which were not found by the last scan.
+  for (int i = 0; i < catalog->items_len; i++) {
+    if (!catalog->items[i].is_seen) {
+      catalog_entry_free(&catalog->items[i].entry);
+      catalog->is_dirty = true;
+      continue;
+    }
+    catalog->items[items_len++] = catalog->items[i];
+  }
+  catalog->items_len = items_len;
+
+  if (!catalog->is_dirty) {
+    return 0;
+  }
+
+  snprintf(dir, sizeof(dir), "%s", catalog->path);
+  err_o = fs_mkdirs(dirname(dir));
+  ERR_TRY(err_o);
+
+  snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", catalog->path);
+  FILE *file = fopen(tmp_path, "wb");
+  if (!file) {
+    err_o = err_errnof(errno, "Cannot create: %s", tmp_path);
+    goto error_out;
+  }
+
+  uint32_t header[] = {CATALOG_VERSION, catalog->items_len};
+  bool is_written = fwrite(CATALOG_MAGIC, 4, 1, file) == 1 &&
+                    fwrite(header, sizeof(header), 1, file) == 1;
+  for (int i = 0; is_written && i < catalog->items_len; i++) {
+    struct CatalogEntry *entry = &catalog->items[i].entry;
+    int32_t pages = entry->pages;
+    uint8_t has_content_box = entry->has_content_box;
+    is_written =
+        catalog_write_str(file, entry->file_name) &&
+        fwrite(&entry->size, sizeof(entry->size), 1, file) == 1 &&
+        fwrite(&entry->mtime, sizeof(entry->mtime), 1, file) == 1 &&
+        catalog_write_str(file, entry->title) &&
+        fwrite(&pages, sizeof(pages), 1, file) == 1 &&
+        fwrite(&has_content_box, sizeof(has_content_box), 1, file) == 1 &&
+        fwrite(&entry->content_box, sizeof(entry->content_box), 1, file) == 1;
+  }
+
+  if (fclose(file) != 0 || !is_written) {
+    err_o = err_errnof(EIO, "Cannot write: %s", tmp_path);
+    goto error_tmp_cleanup;
+  }
+
+  if (rename(tmp_path, catalog->path) == -1) {
+    err_o = err_errnof(errno, "Cannot rename: %s", tmp_path);
+    goto error_tmp_cleanup;
+  }
+
+  catalog->is_dirty = false;
+  log_debug("Catalog saved: %d books", catalog->items_len);
+
+  return 0;
+
+error_tmp_cleanup:
+  remove(tmp_path);
+error_out:
+  return err_o;
+}
+
+/**
+   Catalog which cannot be read is treated as empty, it is only a cache and
+   is rebuilt by the next scan.
+*/
+static void catalog_load(catalog_t catalog) {
+  char magic[4];
+  uint32_t header[2];
+
+  FILE *file = fopen(catalog->path, "rb");
+  if (!file) {
+    return;
+  }
+
+  if (fread(magic, sizeof(magic), 1, file) != 1 ||
+      memcmp(magic, CATALOG_MAGIC, sizeof(magic)) != 0 ||
+      fread(header, sizeof(header), 1, file) != 1 ||
+      header[0] != CATALOG_VERSION) {
+    log_warn("Invalid catalog: %s", catalog->path);
+    goto out;
+  }
+
+  for (uint32_t i = 0; i < header[1]; i++) {
+    struct CatalogEntry entry = {0};
+    uint8_t has_content_box;
+    int32_t pages;
+
+    if (!catalog_read_str(file, &entry.file_name) ||
+        fread(&entry.size, sizeof(entry.size), 1, file) != 1 ||
+        fread(&entry.mtime, sizeof(entry.mtime), 1, file) != 1 ||
+        !catalog_read_str(file, &entry.title) ||
+        fread(&pages, sizeof(pages), 1, file) != 1 ||
+        fread(&has_content_box, sizeof(has_content_box), 1, file) != 1 ||
+        fread(&entry.content_box, sizeof(entry.content_box), 1, file) != 1) {
+      log_warn("Truncated catalog: %s", catalog->path);
+      catalog_entry_free(&entry);
+      goto out;
+    }
+
+    entry.pages = pages;
+    entry.has_content_box = has_content_box;
+    *catalog_add_item(catalog, catalog->items_len) =
+        (struct CatalogItem){.entry = entry};
+  }
+
+  log_debug("Catalog loaded: %d books", catalog->items_len);
+
+out:
+  // Saved catalog is sorted already, unless it was written by an older
+  // version.
+  if (catalog->items_len > 0) {
+    qsort(catalog->items, catalog->items_len, sizeof(struct CatalogItem),
+          catalog_item_cmp);
+  }
+  fclose(file);
+}
+
+static struct CatalogItem *catalog_find_item(catalog_t catalog,
+                                             const char *file_name) {
+  bool is_found;
+
+  int index = catalog_find_index(catalog, file_name, &is_found);
+  return is_found ? &catalog->items[index] : NULL;
+}
+
+/**
+   @return Index of the item of the file or index where the item has to be
+   inserted to keep items sorted.
+*/
+static int catalog_find_index(catalog_t catalog, const char *file_name,
+                              bool *is_found) {
+  int low = 0;
+  int high = catalog->items_len;
+
+  *is_found = false;
+  while (low < high) {
+    int mid = low + (high - low) / 2;
+    int cmp = strcmp(catalog->items[mid].entry.file_name, file_name);
+    if (cmp == 0) {
+      *is_found = true;
+      return mid;
+    }
+
+    if (cmp < 0) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+
+  return low;
+}
+
+static struct CatalogItem *catalog_add_item(catalog_t catalog, int index) {
+  if (catalog->items_len == catalog->items_size) {
+    catalog->items_size = catalog->items_size ? catalog->items_size * 2 : 64;
+    struct CatalogItem *items =
+        mem_malloc(sizeof(struct CatalogItem) * catalog->items_size);
+    if (catalog->items) {
+      memcpy(items, catalog->items,
+             sizeof(struct CatalogItem) * catalog->items_len);
+      mem_free(catalog->items);
+    }
+    catalog->items = items;
+  }
+
+  struct CatalogItem *item = &catalog->items[index];
+  memmove(item + 1, item,
+          sizeof(struct CatalogItem) * (catalog->items_len - index));
+  catalog->items_len++;
+  *item = (struct CatalogItem){0};
+  return item;
+}
+
+static int catalog_item_cmp(const void *a, const void *b) {
+  const struct CatalogItem *item_a = a;
+  const struct CatalogItem *item_b = b;
+  return strcmp(item_a->entry.file_name, item_b->entry.file_name);
+}
+
+static void catalog_entry_free(struct CatalogEntry *entry) {
+  mem_free(entry->file_name);
+  mem_free(entry->title);
+  *entry = (struct CatalogEntry){0};
+}
+
+static bool catalog_read_str(FILE *file, char **out) {
+  uint16_t len;
+
+  if (fread(&len, sizeof(len), 1, file) != 1) {
+    return false;
+  }
+
+  char *str = mem_malloc(len + 1);
+  if (len && fread(str, len, 1, file) != 1) {
+    mem_free(str);
+    return false;
+  }
+  str[len] = 0;
+
+  *out = str;
+  return true;
+}
+
+static bool catalog_write_str(FILE *file, const char *str) {
+  size_t str_len = strlen(str);
+  uint16_t len = str_len > UINT16_MAX ? UINT16_MAX : str_len;
+
+  return fwrite(&len, sizeof(len), 1, file) == 1 &&
+         (len == 0 || fwrite(str, len, 1, file) == 1);
+}
@@ -0,0 +1,67 @@
+#ifndef EBOOK_READER_CATALOG_H
+#define EBOOK_READER_CATALOG_H
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "utils/err.h"
+
+/**
+   Catalog remembers metadata of books found in the books directory, so
+   listing books does not need to open and parse every file again. Entries
+   are valid as long as size and mtime of their file did not change.
+
+   Catalog is stored as a compact binary file and rewritten on save only if
+   something changed since the last save.
+*/
+
+typedef struct Catalog *catalog_t;
+
+// Part of the page covered by content, in fractions of the page size.
+struct ContentBox {
+  float left;
+  float top;
+  float right;
+  float bottom;
+};
+
+struct CatalogEntry {
+  char *file_name;
+  int64_t size;
+  int64_t mtime;
+  char *title;
+  int pages;
+  bool has_content_box;
+  struct ContentBox content_box;
+};
+
+err_t catalog_init(catalog_t *out, const char *path);
+void catalog_destroy(catalog_t *out);
+
+/**
+   @brief Start a new scan of the books directory.
+   @note Entries which are not marked as seen or put before the next save
+   belong to removed files and are dropped from the catalog.
+*/
+void catalog_begin_scan(catalog_t catalog);
+
+/**
+   @brief Keep entry of the file found by the scan, if its size and mtime did
+   not change.
+*/
+void catalog_mark_seen(catalog_t catalog, const char *file_name, int64_t size,
+                       int64_t mtime);
+
+/**
+   @brief Find entry of the file if its size and mtime did not change.
+   @return Entry owned by the catalog or NULL.
+*/
+const struct CatalogEntry *catalog_find(catalog_t catalog,
+                                        const char *file_name, int64_t size,
+                                        int64_t mtime);
+void catalog_put(catalog_t catalog, const struct CatalogEntry *entry);
+void catalog_remove(catalog_t catalog, const char *file_name);
+void catalog_set_content_box(catalog_t catalog, const char *file_name,
+                             const struct ContentBox *box);
+err_t catalog_save(catalog_t catalog);
+
+#endif // EBOOK_READER_CATALOG_H
@@ -1,8 +1,12 @@
 #ifndef EBOOK_READER_BOOK_CORE_H
 #define EBOOK_READER_BOOK_CORE_H
 #include <stdbool.h>
+#include <stdint.h>
 
+#include "library/catalog.h"
 #include "library/library.h"
+#include "library/page_cache.h"
+#include "library/page_store.h"
 #include "utils/err.h"
 #include "utils/zlist.h"
 
@@ -18,7 +22,15 @@ struct Book {
   enum BookExtensionEnum extension;
   struct ZListNode next;
   const char *file_path;
+  int64_t file_size;
+  int64_t file_mtime;
+  // Books start as stubs, see `book_resolve`.
+  bool is_resolved;
+  bool is_initialized;
+  bool is_broken;
   int max_page_number;
+  bool has_content_box;
+  struct ContentBox content_box;
   const char *title;
   library_t owner;
   int page_number;
@@ -28,12 +40,33 @@ struct Book {
   int y_off;
 };
 
+/**
+   `book_init` is called once the book is first used, for example when its
+   card in the menu is about to be shown. Title and page count are read by
+   `book_load` only for books which are not in the catalog yet.
+*/
 struct BookModule {
   err_t (*book_init)(book_t);
+  err_t (*book_load)(book_t);
   void (*book_destroy)(book_t);
   const unsigned char *(*book_get_thumbnail)(book_t, int x, int y);
   const unsigned char *(*book_get_page)(book_t book, int x, int y,
                                         int *buf_len);
+  void (*book_get_cache_stats)(book_t, struct PageCacheStats *);
+  // Called from the library worker thread, has to be thread safe.
+  err_t (*book_render_page)(book_t, const struct PageCacheKey *);
+  // Called from the library worker thread, has to be thread safe.
+  err_t (*book_render_preview)(book_t, const struct PageCacheKey *);
+  const unsigned char *(*book_get_preview)(book_t,
+                                           const struct PageCacheKey *,
+                                           int *buf_len);
+  // Called from the library worker thread, has to be thread safe.
+  err_t (*book_find_content_box)(book_t, const struct PageCacheKey *);
+  bool (*book_get_content_box)(book_t, struct ContentBox *);
+  // Called from a thumbnail worker thread, has to be thread safe.
+  err_t (*book_render_thumbnail)(book_t, const struct PageCacheKey *);
+  bool (*book_has_thumbnail)(book_t);
+  bool (*book_has_page)(book_t, const struct PageCacheKey *);
   bool (*is_extension)(const char *);
   void (*destroy)(book_module_t);
 
@@ -41,5 +74,7 @@ struct BookModule {
 };
 
 err_t book_module_pdf_init(book_module_t, library_t);
+page_store_t library_get_page_store(library_t);
+book_module_t library_get_module(library_t, enum BookExtensionEnum);
 
 #endif // EBOOK_READER_BOOK_CORE_H
@@ -0,0 +1,183 @@
+#include <stdbool.h>
+#include <threads.h>
+
+#include "library/doc_pool.h"
+#include "utils/err.h"
+#include "utils/mem.h"
+
+typedef struct DocPoolEntry *doc_pool_entry_t;
+
+struct DocPoolEntry {
+  uint64_t file_id;
+  void *doc;
+  size_t size;
+  doc_pool_entry_t prev;
+  doc_pool_entry_t next;
+};
+
+/**
+   Entries are kept in a doubly linked list, head is the most recently used
+   document and tail is the first one to close. Only a few documents are
+   kept open, so lookup is linear like in the page cache.
+*/
+struct DocPool {
+  mtx_t lock;
+  doc_pool_entry_t head;
+  doc_pool_entry_t tail;
+  void *(*ref)(void *);
+  void (*unref)(void *);
+  int max_docs;
+  size_t budget;
+  struct DocPoolStats stats;
+};
+
+static doc_pool_entry_t doc_pool_find(doc_pool_t, uint64_t file_id);
+static void doc_pool_unlink(doc_pool_t, doc_pool_entry_t);
+static void doc_pool_link_head(doc_pool_t, doc_pool_entry_t);
+static void doc_pool_entry_destroy(doc_pool_t, doc_pool_entry_t);
+
+err_t doc_pool_init(doc_pool_t *out, int max_docs, size_t budget,
+                    void *(*ref)(void *), void (*unref)(void *)) {
+  if (!out || !ref || !unref) {
+    err_o = err_errnos(EINVAL, "`out`, `ref` and `unref` cannot be NULL");
+    return err_o;
+  }
+
+  doc_pool_t pool = *out = mem_malloc(sizeof(struct DocPool));
+  *pool = (struct DocPool){
+      .ref = ref,
+      .unref = unref,
+      .max_docs = max_docs > 0 ? max_docs : 1,
+      .budget = budget,
+  };
+
+  if (mtx_init(&pool->lock, mtx_plain) != thrd_success) {
+    err_o = err_errnos(ENOMEM, "Cannot create lock for the document pool");
+    mem_free(pool);
+    *out = NULL;
+    return err_o;
+  }
+
+  return 0;
+}
+
+void doc_pool_destroy(doc_pool_t *out) {
+  if (!out || !*out) {
+    return;
+  }
+
+  doc_pool_t pool = *out;
+  while (pool->head) {
+    doc_pool_entry_t entry = pool->head;
+    doc_pool_unlink(pool, entry);
+    doc_pool_entry_destroy(pool, entry);
+  }
+
+  mtx_destroy(&pool->lock);
+  mem_free(pool);
+  *out = NULL;
+}
+
+void *doc_pool_get(doc_pool_t pool, uint64_t file_id) {
+  void *doc = NULL;
+
+  mtx_lock(&pool->lock);
+  doc_pool_entry_t entry = doc_pool_find(pool, file_id);
+  if (entry) {
+    doc_pool_unlink(pool, entry);
+    doc_pool_link_head(pool, entry);
+    doc = pool->ref(entry->doc);
+    pool->stats.hits++;
+  } else {
+    pool->stats.misses++;
+  }
+  mtx_unlock(&pool->lock);
+
+  return doc;
+}
+
+/**
+   Document just put is kept even if it alone exceeds the budget, it is
+   about to be used and would be parsed again right away otherwise.
+*/
+void doc_pool_put(doc_pool_t pool, uint64_t file_id, void *doc, size_t size) {
+  mtx_lock(&pool->lock);
+  doc_pool_entry_t entry = doc_pool_find(pool, file_id);
+  if (entry) {
+    doc_pool_unlink(pool, entry);
+    doc_pool_entry_destroy(pool, entry);
+  }
+
+  while (pool->tail &&
+         ((int)pool->stats.entries + 1 > pool->max_docs ||
+          pool->stats.bytes + size > pool->budget)) {
+    entry = pool->tail;
+    doc_pool_unlink(pool, entry);
+    doc_pool_entry_destroy(pool, entry);
+    pool->stats.evictions++;
+  }
+
+  entry = mem_malloc(sizeof(struct DocPoolEntry));
+  *entry = (struct DocPoolEntry){
+      .file_id = file_id,
+      .doc = pool->ref(doc),
+      .size = size,
+  };
+
+  doc_pool_link_head(pool, entry);
+  mtx_unlock(&pool->lock);
+}
+
+void doc_pool_get_stats(doc_pool_t pool, struct DocPoolStats *out) {
+  mtx_lock(&pool->lock);
+  *out = pool->stats;
+  mtx_unlock(&pool->lock);
+}
+
+static doc_pool_entry_t doc_pool_find(doc_pool_t pool, uint64_t file_id) {
+  for (doc_pool_entry_t entry = pool->head; entry != NULL;
+       entry = entry->next) {
+    if (entry->file_id == file_id) {
+      return entry;
+    }
+  }
+
+  return NULL;
+}
+
+static void doc_pool_unlink(doc_pool_t pool, doc_pool_entry_t entry) {
+  if (entry->prev) {
+    entry->prev->next = entry->next;
+  } else {
+    pool->head = entry->next;
+  }
+
+  if (entry->next) {
+    entry->next->prev = entry->prev;
+  } else {
+    pool->tail = entry->prev;
+  }
+
+  entry->prev = entry->next = NULL;
+  pool->stats.entries--;
+  pool->stats.bytes -= entry->size;
+}
+
+static void doc_pool_link_head(doc_pool_t pool, doc_pool_entry_t entry) {
+  entry->prev = NULL;
+  entry->next = pool->head;
+  if (pool->head) {
+    pool->head->prev = entry;
+  } else {
+    pool->tail = entry;
+  }
+
+  pool->head = entry;
+  pool->stats.entries++;
+  pool->stats.bytes += entry->size;
+}
+
+static void doc_pool_entry_destroy(doc_pool_t pool, doc_pool_entry_t entry) {
+  pool->unref(entry->doc);
+  mem_free(entry);
+}
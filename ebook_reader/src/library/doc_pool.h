@@ -0,0 +1,40 @@
+#ifndef EBOOK_READER_DOC_POOL_H
+#define EBOOK_READER_DOC_POOL_H
+#include <stddef.h>
+#include <stdint.h>
+
+#include "utils/err.h"
+
+/**
+   Document pool keeps parsed documents open between uses, shared by every
+   book of the library, in LRU order. Once the number of documents or their
+   approximate size exceeds the limits, the least recently used ones are
+   closed.
+
+   Documents are keyed by `page_store_file_id`, so a document survives
+   rescans of the library and a modified file is never served from the pool.
+   Pool keeps its own reference of each document. Document returned by
+   `doc_pool_get` is referenced for the caller, release it with `unref` once
+   done, an evicted document stays valid until then.
+
+   Pool is thread safe.
+*/
+
+typedef struct DocPool *doc_pool_t;
+
+struct DocPoolStats {
+  uint32_t hits;
+  uint32_t misses;
+  uint32_t evictions;
+  uint32_t entries;
+  size_t bytes;
+};
+
+err_t doc_pool_init(doc_pool_t *out, int max_docs, size_t budget,
+                    void *(*ref)(void *), void (*unref)(void *));
+void doc_pool_destroy(doc_pool_t *out);
+void *doc_pool_get(doc_pool_t pool, uint64_t file_id);
+void doc_pool_put(doc_pool_t pool, uint64_t file_id, void *doc, size_t size);
+void doc_pool_get_stats(doc_pool_t pool, struct DocPoolStats *out);
+
+#endif // EBOOK_READER_DOC_POOL_H
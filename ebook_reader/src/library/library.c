@@ -1,19 +1,80 @@
 #include <dirent.h>
+#include <math.h>
+#include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
+#include "library/catalog.h"
 #include "library/core.h"
 #include "library/library.h"
 #include "utils/err.h"
 #include "utils/log.h"
 #include "utils/mem.h"
 #include "utils/settings.h"
+#include "utils/time.h"
+#include "utils/worker.h"
 #include "utils/zlist.h"
 
 #define CAST_BOOK_PRIV(node) mem_container_of(node, struct Book, next)
+// Bigger batches are cheaper to pick up with a single rescan.
+#define LIBRARY_WATCH_NAMES_MAX 64
+
+/**
+   Books directory is watched with inotify. Names of changed files are
+   collected until the directory is quiet for a while and then applied to
+   the list of books at once.
+*/
+struct LibraryWatch {
+  int fd;
+  char *names[LIBRARY_WATCH_NAMES_MAX];
+  int names_len;
+  bool is_rescan_needed;
+  uint32_t last_event_time;
+};
 
 struct Library {
   struct BookModule modules[BookExtensionEnum_MAX];
+  worker_t worker;
+  // Thumbnails of different books are rendered in parallel.
+  worker_t thumbnailer;
+  page_store_t page_store;
+  catalog_t catalog;
+  books_list_t books;
+  struct LibraryWatch watch;
+};
+
+struct BookFile {
+  char *file_path;
+  int extension;
+  int64_t size;
+  int64_t mtime;
+};
+
+enum BookJobs {
+  BookJobs_PAGE,
+  BookJobs_PREVIEW,
+  BookJobs_CONTENT_BOX,
+  BookJobs_THUMBNAIL,
+};
+
+typedef err_t (*book_job_func_t)(book_t, const struct PageCacheKey *);
+
+/**
+   Page render executed by the library worker. When `on_ready` is set it is
+   called from the worker thread once the page is in the book's cache, once
+   its preview or thumbnail is ready or once the book's content box is
+   found.
+*/
+struct BookJob {
+  book_t book;
+  struct PageCacheKey key;
+  enum BookJobs kind;
+  void (*on_ready)(book_t, void *);
+  void *data;
 };
 
 struct BooksList {
@@ -25,9 +86,52 @@ struct BooksList {
 static int book_get_extension(library_t lib, const char *path);
 static void books_list_destroy(void *data);
 static void book_destroy(void *data);
+static struct BookFile *library_scan_books(library_t lib, int *len);
+static int book_file_cmp(const void *a, const void *b);
+static bool books_list_is_current(books_list_t list, struct BookFile *files,
+                                  int files_len);
+static books_list_t books_list_create(library_t lib, struct BookFile *files,
+                                      int files_len);
+static book_t book_create(library_t lib, struct BookFile *file);
+static err_t book_resolve(book_t book);
+static struct PageCacheKey book_page_key(book_t book, int page_no, int x,
+                                         int y);
+static void book_submit_job(book_t book, int page_no, int x, int y,
+                            enum BookJobs kind,
+                            void (*on_ready)(book_t, void *), void *data);
+static book_job_func_t book_job_func(book_t book, enum BookJobs kind);
+static bool book_fit_content_box(book_t book, int x, int y);
+static void book_job_run(ref_t data);
+static void book_job_destroy(ref_t data);
+static void library_watch_init(library_t lib);
+static void library_watch_destroy(library_t lib);
+static void library_watch_add(library_t lib, const char *file_name);
+static void library_watch_apply(library_t lib);
+static void library_update_book(library_t lib, const char *file_name);
 
 err_t library_init(library_t *out) {
   library_t lib = *out = mem_malloc(sizeof(struct Library));
+  *lib = (struct Library){.watch = {.fd = -1}};
+
+  err_o = worker_init(&lib->worker, 1);
+  ERR_TRY_CATCH(err_o, error_lib_cleanup);
+
+  int threads = settings_thumbnail_threads > 0
+                    ? settings_thumbnail_threads
+                    : (int)sysconf(_SC_NPROCESSORS_ONLN);
+  err_o = worker_init(&lib->thumbnailer, threads);
+  ERR_TRY_CATCH(err_o, error_worker_cleanup);
+
+  // Books can be read without the page store, e.g. from read-only card.
+  err_o = page_store_init(&lib->page_store, settings_page_store_dir,
+                          settings_page_store_bytes);
+  if (err_o) {
+    log_error(err_o);
+    err_o = 0;
+  }
+
+  err_o = catalog_init(&lib->catalog, settings_catalog_path);
+  ERR_TRY_CATCH(err_o, error_store_cleanup);
 
   err_t (*module_inits[BookExtensionEnum_MAX])(book_module_t, library_t) = {
       [BookExtensionEnum_PDF] = book_module_pdf_init,
@@ -43,6 +147,8 @@ err_t library_init(library_t *out) {
     ERR_TRY(err_o);
   }
 
+  library_watch_init(lib);
+
   return 0;
 
 error_out:
@@ -53,6 +159,13 @@ error_out:
     lib->modules[inits_status].destroy(&lib->modules[inits_status]);
   }
 
+  catalog_destroy(&lib->catalog);
+error_store_cleanup:
+  page_store_destroy(&lib->page_store);
+  worker_destroy(&lib->thumbnailer);
+error_worker_cleanup:
+  worker_destroy(&lib->worker);
+error_lib_cleanup:
   mem_free(*out);
   *out = NULL;
   return err_o;
@@ -65,6 +178,13 @@ void library_destroy(library_t *out) {
   }
 
   library_t lib = *out;
+
+  // Pending jobs hold books, books have to be released before modules.
+  worker_destroy(&lib->thumbnailer);
+  worker_destroy(&lib->worker);
+  library_watch_destroy(lib);
+  mem_deref(lib->books);
+
   for (int inits_status = BookExtensionEnum_MAX - 1;
        inits_status >= BookExtensionEnum_PDF; inits_status--) {
     if (!lib->modules[inits_status].destroy) {
@@ -73,26 +193,276 @@ void library_destroy(library_t *out) {
     lib->modules[inits_status].destroy(&lib->modules[inits_status]);
   }
 
+  page_store_destroy(&lib->page_store);
+
+  err_o = catalog_save(lib->catalog);
+  if (err_o) {
+    log_error(err_o);
+  }
+  catalog_destroy(&lib->catalog);
   mem_free(*out);
   *out = NULL;
 };
 
+/**
+   While the books directory is watched the list is kept up to date by
+   `library_watch_step` and is returned as is. Otherwise the directory is
+   scanned on every call, but only `stat` data is read. If no file changed
+   since the last call the same list is returned, so books keep their
+   thumbnails and rendered pages. Otherwise the list is rebuilt, with
+   metadata of unchanged files taken from the catalog.
+*/
 books_list_t library_list_books(library_t lib) {
+  int files_len;
+
+  if (lib->watch.fd != -1 && lib->books) {
+    goto out;
+  }
+
+  struct BookFile *files = library_scan_books(lib, &files_len);
+  if (!files) {
+    goto error_out;
+  }
+
+  if (!lib->books || !books_list_is_current(lib->books, files, files_len)) {
+    mem_deref(lib->books);
+    lib->books = books_list_create(lib, files, files_len);
+  }
+
+  for (int i = 0; i < files_len; i++) {
+    mem_free(files[i].file_path);
+  }
+  mem_free(files);
+
+out:
+  // Books resolved since the last listing are cataloged here.
+  err_o = catalog_save(lib->catalog);
+  if (err_o) {
+    log_error(err_o);
+  }
+
+  books_list_reset(lib->books);
+  return mem_ref(lib->books);
+
+error_out:
+  return NULL;
+};
+
+int library_watch_fd(library_t lib) { return lib->watch.fd; }
+
+int library_watch_timeout(library_t lib) {
+  struct LibraryWatch *watch = &lib->watch;
+
+  if (!watch->names_len && !watch->is_rescan_needed) {
+    return -1;
+  }
+
+  int elapsed = time_now() - watch->last_event_time;
+  return elapsed >= settings_library_debounce_ms
+             ? 0
+             : settings_library_debounce_ms - elapsed;
+}
+
+/**
+   Events are read without blocking, changes are applied only once the
+   directory was quiet for `settings_library_debounce_ms`.
+*/
+bool library_watch_step(library_t lib) {
+  _Alignas(struct inotify_event) char buf[4096];
+  struct LibraryWatch *watch = &lib->watch;
+  ssize_t len;
+
+  if (watch->fd == -1) {
+    return false;
+  }
+
+  while ((len = read(watch->fd, buf, sizeof(buf))) > 0) {
+    for (char *ptr = buf; ptr < buf + len;) {
+      struct inotify_event *event = (struct inotify_event *)ptr;
+      ptr += sizeof(struct inotify_event) + event->len;
+      watch->last_event_time = time_now();
+
+      if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED)) {
+        // Directory is gone, e.g. card was removed, fall back to scans.
+        log_warn("Books directory is not watched anymore: %s",
+                 settings_books_dir);
+        library_watch_destroy(lib);
+        mem_deref(lib->books);
+        lib->books = NULL;
+        return true;
+      }
+
+      if (event->mask & IN_Q_OVERFLOW) {
+        watch->is_rescan_needed = true;
+        continue;
+      }
+
+      if (event->len) {
+        library_watch_add(lib, event->name);
+      }
+    }
+  }
+
+  if (library_watch_timeout(lib) != 0) {
+    return false;
+  }
+
+  library_watch_apply(lib);
+  return true;
+}
+
+static void library_watch_init(library_t lib) {
+  struct LibraryWatch *watch = &lib->watch;
+
+  // Without the watch books directory is scanned on every listing.
+  watch->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (watch->fd == -1) {
+    log_warn("Cannot create inotify instance: %s", strerror(errno));
+    return;
+  }
+
+  // Files are picked up once they are fully written, not on creation.
+  if (inotify_add_watch(watch->fd, settings_books_dir,
+                        IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM |
+                            IN_DELETE | IN_DELETE_SELF | IN_MOVE_SELF) == -1) {
+    log_warn("Cannot watch directory: %s: %s", settings_books_dir,
+             strerror(errno));
+    close(watch->fd);
+    watch->fd = -1;
+  }
+}
+
+static void library_watch_destroy(library_t lib) {
+  struct LibraryWatch *watch = &lib->watch;
+
+  if (watch->fd != -1) {
+    close(watch->fd);
+  }
+
+  for (int i = 0; i < watch->names_len; i++) {
+    mem_free(watch->names[i]);
+  }
+
+  *watch = (struct LibraryWatch){.fd = -1};
+}
+
+static void library_watch_add(library_t lib, const char *file_name) {
+  struct LibraryWatch *watch = &lib->watch;
+
+  if (book_get_extension(lib, file_name) == -1 || watch->is_rescan_needed) {
+    return;
+  }
+
+  for (int i = 0; i < watch->names_len; i++) {
+    if (strcmp(watch->names[i], file_name) == 0) {
+      return;
+    }
+  }
+
+  if (watch->names_len == LIBRARY_WATCH_NAMES_MAX) {
+    watch->is_rescan_needed = true;
+    return;
+  }
+
+  watch->names[watch->names_len++] = strdup(file_name);
+}
+
+/**
+   Books which were not listed yet are created by the next listing, so only
+   a list which already exists is updated.
+*/
+static void library_watch_apply(library_t lib) {
+  struct LibraryWatch *watch = &lib->watch;
+
+  if (watch->is_rescan_needed) {
+    log_info("Too many changes in books directory, rescanning");
+    mem_deref(lib->books);
+    lib->books = NULL;
+  }
+
+  for (int i = 0; i < watch->names_len; i++) {
+    if (lib->books) {
+      library_update_book(lib, watch->names[i]);
+    }
+    mem_free(watch->names[i]);
+  }
+
+  watch->names_len = 0;
+  watch->is_rescan_needed = false;
+
+  if (!lib->books) {
+    return;
+  }
+
+  books_list_reset(lib->books);
+
+  err_o = catalog_save(lib->catalog);
+  if (err_o) {
+    log_error(err_o);
+  }
+}
+
+/**
+   Old book of the file is dropped and a new one is created if the file
+   still exists. Renames are delivered as removal of the old name and
+   addition of the new one.
+*/
+static void library_update_book(library_t lib, const char *file_name) {
+  struct stat st;
+  int i = 0;
+
+  int bytes = snprintf(NULL, 0, "%s/%s", settings_books_dir, file_name) + 1;
+  char *file_path = mem_malloc(bytes);
+  snprintf(file_path, bytes, "%s/%s", settings_books_dir, file_name);
+
+  for (zlist_node_t node = lib->books->books.head; node != NULL;
+       node = node->next, i++) {
+    if (strcmp(CAST_BOOK_PRIV(node)->file_path, file_path) == 0) {
+      mem_deref(books_list_pop(lib->books, i));
+      break;
+    }
+  }
+
+  if (stat(file_path, &st) == -1) {
+    log_info("Book removed: %s", file_path);
+    catalog_remove(lib->catalog, file_name);
+    goto out;
+  }
+
+  book_t book = book_create(lib, &(struct BookFile){
+                                     .file_path = file_path,
+                                     .extension =
+                                         book_get_extension(lib, file_name),
+                                     .size = st.st_size,
+                                     .mtime = st.st_mtime,
+                                 });
+  log_info("Book added: %s", file_path);
+
+  // Keep the order of scanned books, see `book_file_cmp`.
+  i = 0;
+  for (zlist_node_t node = lib->books->books.head;
+       node != NULL && strcmp(CAST_BOOK_PRIV(node)->file_path, file_path) < 0;
+       node = node->next) {
+    i++;
+  }
+  zlist_insert(&lib->books->books, i, &book->next);
+
+out:
+  mem_free(file_path);
+}
+
+static struct BookFile *library_scan_books(library_t lib, int *len) {
+  struct BookFile *files = NULL;
   struct dirent *dirent;
-  DIR *books_dir;
-  int book_ext;
-  book_t book;
+  int files_size = 0;
+  struct stat st;
 
-  books_list_t list =
-      mem_refalloc(sizeof(struct BooksList), books_list_destroy);
-  *list = (struct BooksList){
-      .owner = lib,
-  };
+  *len = 0;
 
-  books_dir = opendir(settings_books_dir);
+  DIR *books_dir = opendir(settings_books_dir);
   if (!books_dir) {
-    err_o = err_errnof(errno, "Cannot open directory: %s", books_dir);
-    goto error_out;
+    err_o = err_errnof(errno, "Cannot open directory: %s", settings_books_dir);
+    return NULL;
   }
 
   while ((dirent = readdir(books_dir)) != NULL) {
@@ -100,7 +470,7 @@ books_list_t library_list_books(library_t lib) {
       continue;
     }
 
-    book_ext = book_get_extension(lib, dirent->d_name);
+    int book_ext = book_get_extension(lib, dirent->d_name);
     if (book_ext == -1) {
       continue;
     };
@@ -110,41 +480,176 @@ books_list_t library_list_books(library_t lib) {
     char *file_path = mem_malloc(bytes);
     snprintf(file_path, bytes, "%s/%s", settings_books_dir, dirent->d_name);
 
-    book = mem_refalloc(sizeof(struct Book), book_destroy);
+    if (stat(file_path, &st) == -1) {
+      mem_free(file_path);
+      continue;
+    }
 
-    log_debug("Creating book: %p=%s", book, file_path);
+    if (*len == files_size) {
+      files_size = files_size ? files_size * 2 : 64;
+      struct BookFile *tmp = mem_malloc(sizeof(struct BookFile) * files_size);
+      if (files) {
+        memcpy(tmp, files, sizeof(struct BookFile) * *len);
+        mem_free(files);
+      }
+      files = tmp;
+    }
 
-    *book = (struct Book){
-        .extension = book_ext,
+    files[(*len)++] = (struct BookFile){
         .file_path = file_path,
-        .owner = lib,
-        .scale = 1,
-        .page_number = 1,
+        .extension = book_ext,
+        .size = st.st_size,
+        .mtime = st.st_mtime,
     };
+  }
 
-    zlist_append(&list->books, &book->next);
+  closedir(books_dir);
 
-    if (!list->current_book) {
-      list->current_book = list->books.head;
-    }
+  // Empty directory is not an error, list of books is just empty.
+  if (!files) {
+    files = mem_malloc(sizeof(struct BookFile));
+  }
 
-    if (lib->modules[book_ext].book_init) {
-      err_o = lib->modules[book_ext].book_init(book);
-      ERR_TRY_CATCH(err_o, error_list_cleanup);
+  // Books are listed by file name instead of the directory order.
+  qsort(files, *len, sizeof(struct BookFile), book_file_cmp);
+
+  return files;
+}
+
+static int book_file_cmp(const void *a, const void *b) {
+  const struct BookFile *file_a = a;
+  const struct BookFile *file_b = b;
+  return strcmp(file_a->file_path, file_b->file_path);
+}
+
+/**
+   List is created from sorted files, so both are compared in one pass. List
+   extended by `library_watch_step` is out of order and is rebuilt.
+*/
+static bool books_list_is_current(books_list_t list, struct BookFile *files,
+                                  int files_len) {
+  if ((int)list->books.len != files_len) {
+    return false;
+  }
+
+  zlist_node_t node = list->books.head;
+  for (int i = 0; i < files_len; i++, node = node->next) {
+    book_t book = CAST_BOOK_PRIV(node);
+    if (strcmp(book->file_path, files[i].file_path) != 0 ||
+        book->file_size != files[i].size ||
+        book->file_mtime != files[i].mtime) {
+      return false;
     }
   }
 
-  closedir(books_dir);
+  return true;
+}
+
+static books_list_t books_list_create(library_t lib, struct BookFile *files,
+                                      int files_len) {
+  books_list_t list =
+      mem_refalloc(sizeof(struct BooksList), books_list_destroy);
+  *list = (struct BooksList){
+      .owner = lib,
+  };
+
+  catalog_begin_scan(lib->catalog);
+
+  // Books are prepended from the last one, appending walks the whole list.
+  for (int i = files_len - 1; i >= 0; i--) {
+    book_t book = book_create(lib, &files[i]);
+    zlist_prepend(&list->books, &book->next);
+  }
+
+  list->current_book = list->books.head;
 
   return list;
+}
+
+/**
+   Books are created as stubs knowing only their file. Catalog entry of an
+   unchanged file is only marked as seen, metadata itself is resolved by
+   `book_resolve` once the book is used.
+*/
+static book_t book_create(library_t lib, struct BookFile *file) {
+  const char *file_name = strrchr(file->file_path, '/') + 1;
+
+  book_t book = mem_refalloc(sizeof(struct Book), book_destroy);
+
+  *book = (struct Book){
+      .extension = file->extension,
+      .file_path = strdup(file->file_path),
+      .file_size = file->size,
+      .file_mtime = file->mtime,
+      .owner = lib,
+      .scale = 1,
+      .page_number = 1,
+  };
+
+  catalog_mark_seen(lib->catalog, file_name, file->size, file->mtime);
+
+  return book;
+}
+
+/**
+   Metadata of a book is loaded by its module only if the catalog does not
+   know the file yet or the file changed since it was cataloged. Book which
+   cannot be loaded stays in the list under its file name, but has no pages.
+*/
+static err_t book_resolve(book_t book) {
+  struct BookModule *module = &book->owner->modules[book->extension];
+  const char *file_name = strrchr(book->file_path, '/') + 1;
+
+  if (book->is_resolved) {
+    if (book->is_broken) {
+      return err_errnof(ENODATA, "Cannot load book: %s", book->file_path);
+    }
+    return 0;
+  }
+
+  log_debug("Resolving book: %p=%s", book, book->file_path);
+  book->is_resolved = true;
+
+  if (module->book_init) {
+    err_o = module->book_init(book);
+    ERR_TRY(err_o);
+  }
+  book->is_initialized = true;
+
+  const struct CatalogEntry *entry = catalog_find(
+      book->owner->catalog, file_name, book->file_size, book->file_mtime);
+  if (entry) {
+    book->title = strdup(entry->title);
+    book->max_page_number = entry->pages;
+    book->has_content_box = entry->has_content_box;
+    book->content_box = entry->content_box;
+    return 0;
+  }
+
+  if (module->book_load) {
+    err_o = module->book_load(book);
+    ERR_TRY(err_o);
+  }
+
+  catalog_put(book->owner->catalog,
+              &(struct CatalogEntry){
+                  .file_name = (char *)file_name,
+                  .size = book->file_size,
+                  .mtime = book->file_mtime,
+                  .title = (char *)book->title,
+                  .pages = book->max_page_number,
+              });
+
+  return 0;
 
-error_list_cleanup:
-  books_list_destroy(list);
-  closedir(books_dir);
 error_out:
-  mem_free(list);
-  return NULL;
-};
+  log_error(err_o);
+  book->is_broken = true;
+  if (!book->title) {
+    book->title = strdup(file_name);
+  }
+  return err_o;
+}
 
 static void books_list_destroy(void *data) {
 
@@ -190,12 +695,50 @@ static int book_get_extension(library_t lib, const char *path) {
   return -1;
 }
 
-const char *book_get_title(book_t book) { return book->title; }
+const char *book_get_title(book_t book) {
+  book_resolve(book);
+  return book->title;
+}
+
+page_store_t library_get_page_store(library_t lib) { return lib->page_store; }
+
+book_module_t library_get_module(library_t lib,
+                                 enum BookExtensionEnum extension) {
+  return &lib->modules[extension];
+}
 
 const unsigned char *book_get_thumbnail(book_t book, int x, int y) {
+  if (book_resolve(book)) {
+    return NULL;
+  }
+
   return book->owner->modules[book->extension].book_get_thumbnail(book, x, y);
 }
 
+/**
+   Books are resolved here, on the main loop, as the catalog is not thread
+   safe. Only rendering of the cover runs on the thumbnail workers.
+*/
+bool book_request_thumbnail(book_t book, int x, int y,
+                            void (*on_ready)(book_t, void *), void *data) {
+  struct BookModule *module = &book->owner->modules[book->extension];
+
+  if (book_resolve(book)) {
+    return false;
+  }
+
+  if (!module->book_has_thumbnail || module->book_has_thumbnail(book)) {
+    return true;
+  }
+
+  book_submit_job(book, 1, x, y, BookJobs_THUMBNAIL, on_ready, data);
+  return false;
+}
+
+void library_cancel_thumbnails(library_t lib) {
+  worker_cancel(lib->thumbnailer, lib);
+}
+
 int books_list_len(books_list_t list) { return list->books.len; }
 
 book_t books_list_pop(books_list_t list, int idx) {
@@ -214,7 +757,10 @@ static void book_destroy(void *data) {
     return;
   }
 
-  book->owner->modules[book->extension].book_destroy(book);
+  if (book->is_initialized) {
+    book->owner->modules[book->extension].book_destroy(book);
+  }
+  mem_free((void *)book->title);
   mem_free((void *)book->file_path);
 };
 
@@ -228,14 +774,233 @@ void books_list_remove(books_list_t list, book_t book) {
 }
 
 const unsigned char *book_get_page(book_t book, int x, int y, int *buf_len) {
+  err_o = book_resolve(book);
+  if (err_o) {
+    return NULL;
+  }
 
   return book->owner->modules[book->extension].book_get_page(book, x, y,
                                                              buf_len);
 }
 
+void book_get_cache_stats(book_t book, struct PageCacheStats *out) {
+  *out = (struct PageCacheStats){0};
+  if (!book->is_initialized ||
+      !book->owner->modules[book->extension].book_get_cache_stats) {
+    return;
+  }
+
+  book->owner->modules[book->extension].book_get_cache_stats(book, out);
+}
+
+bool book_is_page_cached(book_t book, int x, int y) {
+  if (book_resolve(book) ||
+      !book->owner->modules[book->extension].book_has_page) {
+    return false;
+  }
+
+  struct PageCacheKey key = book_page_key(book, book->page_number, x, y);
+  return book->owner->modules[book->extension].book_has_page(book, &key);
+}
+
+/**
+   Render of the current page goes in front of everything else the book has
+   queued. Older requests and prefetches are for a position the user has
+   already left, so they are dropped and only the latest page gets rendered.
+
+   Full render is preceded by a quick low resolution preview, so the user
+   sees the page before a heavy page is done. Next request drops the full
+   render if it has not started yet.
+*/
+void book_request_page(book_t book, int x, int y,
+                       void (*on_ready)(book_t, void *), void *data) {
+  book_cancel_page_jobs(book);
+  if (settings_preview_divisor > 1) {
+    book_submit_job(book, book->page_number, x, y, BookJobs_PREVIEW, on_ready,
+                    data);
+  }
+  book_submit_job(book, book->page_number, x, y, BookJobs_PAGE, on_ready, data);
+}
+
+const unsigned char *book_get_preview(book_t book, int x, int y,
+                                      int *buf_len) {
+  if (book_resolve(book) ||
+      !book->owner->modules[book->extension].book_get_preview) {
+    return NULL;
+  }
+
+  struct PageCacheKey key = book_page_key(book, book->page_number, x, y);
+  return book->owner->modules[book->extension].book_get_preview(book, &key,
+                                                                buf_len);
+}
+
+/**
+   Neighbouring pages are rendered on the library worker, so a page turn
+   usually finds its page in the book's page cache.
+*/
+void book_prefetch(book_t book, int x, int y) {
+  for (int i = 1; i <= settings_prefetch_ahead; i++) {
+    book_submit_job(book, book->page_number + i, x, y, BookJobs_PAGE, NULL,
+                    NULL);
+  }
+
+  for (int i = 1; i <= settings_prefetch_behind; i++) {
+    book_submit_job(book, book->page_number - i, x, y, BookJobs_PAGE, NULL,
+                    NULL);
+  }
+}
+
+/**
+   Content box is found once per book and kept in the catalog, so margins of
+   a book cost a few sample renders only on its first open. Analysis runs
+   under its own worker owner, page requests do not cancel it.
+
+   Book which the user has already scaled or moved is left as is.
+*/
+bool book_auto_crop(book_t book, int x, int y,
+                    void (*on_ready)(book_t, void *), void *data) {
+  struct BookModule *module = &book->owner->modules[book->extension];
+
+  if (!settings_auto_crop || book_resolve(book) ||
+      !module->book_get_content_box) {
+    return false;
+  }
+
+  if (book->scale != 1 || book->x_off || book->y_off) {
+    return false;
+  }
+
+  if (!book->has_content_box) {
+    if (!module->book_get_content_box(book, &book->content_box)) {
+      book_submit_job(book, 1, x, y, BookJobs_CONTENT_BOX, on_ready, data);
+      return false;
+    }
+
+    book->has_content_box = true;
+    catalog_set_content_box(book->owner->catalog,
+                            strrchr(book->file_path, '/') + 1,
+                            &book->content_box);
+  }
+
+  return book_fit_content_box(book, x, y);
+}
+
+void book_cancel_page_jobs(book_t book) {
+  worker_cancel(book->owner->worker, book);
+}
+
+void book_cancel_jobs(book_t book) {
+  book_cancel_page_jobs(book);
+  worker_cancel(book->owner->worker, &book->content_box);
+}
+
+/**
+   Content is scaled up until it fills the panel along one axis and centered
+   along the other one. Box which covers nearly whole page is not worth a
+   crop, a tiny one is more likely a stray mark than the text.
+*/
+static bool book_fit_content_box(book_t book, int x, int y) {
+  const struct ContentBox *box = &book->content_box;
+  double box_w = box->right - box->left;
+  double box_h = box->bottom - box->top;
+
+  if (box_w < 0.2 || box_h < 0.2 || (box_w > 0.97 && box_h > 0.97)) {
+    return false;
+  }
+
+  double scale = fmin(1 / box_w, 1 / box_h);
+
+  book->scale = scale;
+  book->x_off = lround((x - box_w * x * scale) / 2 / scale - box->left * x);
+  book->y_off = lround((y - box_h * y * scale) / 2 / scale - box->top * y);
+
+  return true;
+}
+
+static struct PageCacheKey book_page_key(book_t book, int page_no, int x,
+                                         int y) {
+  return (struct PageCacheKey){
+      .page_number = page_no,
+      .scale = book->scale,
+      .x_off = book->x_off,
+      .y_off = book->y_off,
+      .x = x,
+      .y = y,
+  };
+}
+
+static void book_submit_job(book_t book, int page_no, int x, int y,
+                            enum BookJobs kind,
+                            void (*on_ready)(book_t, void *), void *data) {
+  if (book_resolve(book) || !book_job_func(book, kind)) {
+    return;
+  }
+
+  if (page_no < 1 || page_no > book->max_page_number) {
+    return;
+  }
+
+  struct BookJob *job = mem_refalloc(sizeof(struct BookJob), book_job_destroy);
+  *job = (struct BookJob){
+      .book = mem_ref(book),
+      .key = book_page_key(book, page_no, x, y),
+      .kind = kind,
+      .on_ready = on_ready,
+      .data = data,
+  };
+
+  switch (kind) {
+  case BookJobs_THUMBNAIL:
+    worker_submit(book->owner->thumbnailer, book->owner, book_job_run, job);
+    break;
+  case BookJobs_CONTENT_BOX:
+    worker_submit(book->owner->worker, &book->content_box, book_job_run, job);
+    break;
+  default:
+    worker_submit(book->owner->worker, book, book_job_run, job);
+  }
+  mem_deref(job);
+}
+
+static void book_job_run(ref_t data) {
+  struct BookJob *job = data;
+  book_t book = job->book;
+
+  err_o = book_job_func(book, job->kind)(book, &job->key);
+  if (err_o) {
+    log_error(err_o);
+    return;
+  }
+
+  if (job->on_ready) {
+    job->on_ready(book, job->data);
+  }
+}
+
+static book_job_func_t book_job_func(book_t book, enum BookJobs kind) {
+  struct BookModule *module = &book->owner->modules[book->extension];
+
+  switch (kind) {
+  case BookJobs_PREVIEW:
+    return module->book_render_preview;
+  case BookJobs_CONTENT_BOX:
+    return module->book_find_content_box;
+  case BookJobs_THUMBNAIL:
+    return module->book_render_thumbnail;
+  default:
+    return module->book_render_page;
+  }
+}
+
+static void book_job_destroy(ref_t data) {
+  struct BookJob *job = data;
+  mem_deref(job->book);
+}
+
 int book_get_page_no(book_t book) { return book->page_number; }
 
 void book_set_page_no(book_t book, int page_no) {
+  book_resolve(book);
   if (page_no >= book->max_page_number) {
     page_no = book->max_page_number;
   } else if (page_no < 1) {
@@ -247,7 +1012,10 @@ void book_set_page_no(book_t book, int page_no) {
 
 void book_set_scale(book_t book, double value) { book->scale = value; }
 
-int book_get_max_page_no(book_t book) { return book->max_page_number; }
+int book_get_max_page_no(book_t book) {
+  book_resolve(book);
+  return book->max_page_number;
+}
 
 double book_get_scale(book_t book) { return book->scale; }
 
@@ -1,15 +1,36 @@
 #ifndef EBOOK_READER_LIBRARY_H
 #define EBOOK_READER_LIBRARY_H
 
+#include <stdbool.h>
+
 #include "utils/err.h"
 
 typedef struct Library *library_t;
 typedef struct Book *book_t;
 typedef struct BooksList *books_list_t;
+struct PageCacheStats;
 
 err_t library_init(library_t *out);
 void library_destroy(library_t *out);
 books_list_t library_list_books(library_t lib);
+
+/**
+   @brief File descriptor which becomes readable when the books directory
+   changes, -1 if the directory is not watched.
+*/
+int library_watch_fd(library_t lib);
+
+/**
+   @brief Milliseconds until pending changes are due to be applied, -1 if
+   there are no pending changes.
+*/
+int library_watch_timeout(library_t lib);
+
+/**
+   @brief Process changes in the books directory.
+   @return True if the list of books was updated.
+*/
+bool library_watch_step(library_t lib);
 book_t books_list_get(books_list_t);
 int books_list_len(books_list_t);
 void books_list_reset(books_list_t);
@@ -27,5 +48,42 @@ int book_get_page_no(book_t);
 void book_set_page_no(book_t, int);
 int book_get_max_page_no(book_t);
 const unsigned char *book_get_thumbnail(book_t, int x, int y);
+/**
+   @brief Render thumbnail of the book on the thumbnail workers. `on_ready` is
+   called from a worker thread once `book_get_thumbnail` returns it without
+   rendering.
+   @return True if the thumbnail is ready already, nothing is rendered then.
+*/
+bool book_request_thumbnail(book_t book, int x, int y,
+                            void (*on_ready)(book_t, void *), void *data);
+/**
+   @brief Drop pending thumbnail renders of all books.
+*/
+void library_cancel_thumbnails(library_t lib);
+void book_get_cache_stats(book_t, struct PageCacheStats *);
+bool book_is_page_cached(book_t book, int x, int y);
+void book_request_page(book_t book, int x, int y,
+                       void (*on_ready)(book_t, void *), void *data);
+/**
+   @brief Get preview of the current page rendered by `book_request_page`.
+   @return Page data or NULL if there is no preview of the current page.
+*/
+const unsigned char *book_get_preview(book_t book, int x, int y,
+                                      int *buf_len);
+void book_prefetch(book_t book, int x, int y);
+/**
+   @brief Scale and move the book so its content without margins fills the
+   panel. `on_ready` is called from the worker once the content box of a new
+   book is found, the call should be repeated then.
+   @return True if scale and offsets of the book changed.
+*/
+bool book_auto_crop(book_t book, int x, int y,
+                    void (*on_ready)(book_t, void *), void *data);
+/**
+   @brief Cancel page renders and prefetches of the book, content box search
+   keeps going.
+*/
+void book_cancel_page_jobs(book_t book);
+void book_cancel_jobs(book_t book);
 
 #endif // EBOOK_READER_LIBRARY_H
@@ -0,0 +1,176 @@
+#include <stdbool.h>
+
+#include "library/page_cache.h"
+#include "utils/err.h"
+#include "utils/mem.h"
+
+typedef struct PageCacheEntry *page_cache_entry_t;
+
+struct PageCacheEntry {
+  struct PageCacheKey key;
+  void *value;
+  size_t size;
+  page_cache_entry_t prev;
+  page_cache_entry_t next;
+};
+
+/**
+   Entries are kept in a doubly linked list, head is the most recently used
+   page and tail is the first one to evict. A book caches only a handful of
+   pages, so linear lookup is cheaper than maintaining a hash table.
+*/
+struct PageCache {
+  page_cache_entry_t head;
+  page_cache_entry_t tail;
+  void (*value_destroy)(void *);
+  size_t budget;
+  struct PageCacheStats stats;
+};
+
+static void page_cache_unlink(page_cache_t, page_cache_entry_t);
+static void page_cache_link_head(page_cache_t, page_cache_entry_t);
+static void page_cache_entry_destroy(page_cache_t, page_cache_entry_t);
+
+err_t page_cache_init(page_cache_t *out, size_t budget,
+                      void (*value_destroy)(void *)) {
+  if (!out || !value_destroy) {
+    err_o = err_errnos(EINVAL, "`out` and `value_destroy` cannot be NULL");
+    return err_o;
+  }
+
+  page_cache_t cache = *out = mem_malloc(sizeof(struct PageCache));
+  *cache = (struct PageCache){
+      .value_destroy = value_destroy,
+      .budget = budget,
+  };
+
+  return 0;
+}
+
+void page_cache_destroy(page_cache_t *out) {
+  if (!out || !*out) {
+    return;
+  }
+
+  page_cache_t cache = *out;
+  while (cache->head) {
+    page_cache_entry_t entry = cache->head;
+    page_cache_unlink(cache, entry);
+    page_cache_entry_destroy(cache, entry);
+  }
+
+  mem_free(cache);
+  *out = NULL;
+}
+
+void *page_cache_get(page_cache_t cache, const struct PageCacheKey *key) {
+  for (page_cache_entry_t entry = cache->head; entry != NULL;
+       entry = entry->next) {
+    if (!page_cache_key_equal(&entry->key, key)) {
+      continue;
+    }
+
+    page_cache_unlink(cache, entry);
+    page_cache_link_head(cache, entry);
+    cache->stats.hits++;
+    return entry->value;
+  }
+
+  cache->stats.misses++;
+  return NULL;
+}
+
+bool page_cache_has(page_cache_t cache, const struct PageCacheKey *key) {
+  for (page_cache_entry_t entry = cache->head; entry != NULL;
+       entry = entry->next) {
+    if (page_cache_key_equal(&entry->key, key)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void page_cache_put(page_cache_t cache, const struct PageCacheKey *key,
+                    void *value, size_t size) {
+  // Page that does not fit into the budget would evict everything else and
+  // still could not be kept, so it is released right away.
+  if (size > cache->budget) {
+    cache->value_destroy(value);
+    return;
+  }
+
+  for (page_cache_entry_t entry = cache->head; entry != NULL;
+       entry = entry->next) {
+    if (page_cache_key_equal(&entry->key, key)) {
+      page_cache_unlink(cache, entry);
+      page_cache_entry_destroy(cache, entry);
+      break;
+    }
+  }
+
+  while (cache->tail && cache->stats.bytes + size > cache->budget) {
+    page_cache_entry_t entry = cache->tail;
+    page_cache_unlink(cache, entry);
+    page_cache_entry_destroy(cache, entry);
+    cache->stats.evictions++;
+  }
+
+  page_cache_entry_t entry = mem_malloc(sizeof(struct PageCacheEntry));
+  *entry = (struct PageCacheEntry){
+      .key = *key,
+      .value = value,
+      .size = size,
+  };
+
+  page_cache_link_head(cache, entry);
+}
+
+void page_cache_get_stats(page_cache_t cache, struct PageCacheStats *out) {
+  *out = cache->stats;
+}
+
+bool page_cache_key_equal(const struct PageCacheKey *a,
+                          const struct PageCacheKey *b) {
+  return a->page_number == b->page_number && a->scale == b->scale &&
+         a->x_off == b->x_off && a->y_off == b->y_off && a->x == b->x &&
+         a->y == b->y;
+}
+
+static void page_cache_unlink(page_cache_t cache, page_cache_entry_t entry) {
+  if (entry->prev) {
+    entry->prev->next = entry->next;
+  } else {
+    cache->head = entry->next;
+  }
+
+  if (entry->next) {
+    entry->next->prev = entry->prev;
+  } else {
+    cache->tail = entry->prev;
+  }
+
+  entry->prev = entry->next = NULL;
+  cache->stats.entries--;
+  cache->stats.bytes -= entry->size;
+}
+
+static void page_cache_link_head(page_cache_t cache, page_cache_entry_t entry) {
+  entry->prev = NULL;
+  entry->next = cache->head;
+  if (cache->head) {
+    cache->head->prev = entry;
+  } else {
+    cache->tail = entry;
+  }
+
+  cache->head = entry;
+  cache->stats.entries++;
+  cache->stats.bytes += entry->size;
+}
+
+static void page_cache_entry_destroy(page_cache_t cache,
+                                     page_cache_entry_t entry) {
+  cache->value_destroy(entry->value);
+  mem_free(entry);
+}
@@ -0,0 +1,51 @@
+#ifndef EBOOK_READER_PAGE_CACHE_H
+#define EBOOK_READER_PAGE_CACHE_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "utils/err.h"
+
+/**
+   Page cache keeps rendered pages in LRU order until their total size
+   exceeds the byte budget, then the least recently used pages are evicted.
+
+   Cache owns every value put into it and releases it with `value_destroy`.
+   Value returned by `page_cache_get` is borrowed, keep your own reference
+   if it has to outlive the next `page_cache_put`.
+*/
+
+typedef struct PageCache *page_cache_t;
+
+struct PageCacheKey {
+  int page_number;
+  double scale;
+  int x_off;
+  int y_off;
+  int x;
+  int y;
+};
+
+struct PageCacheStats {
+  uint32_t hits;
+  uint32_t misses;
+  uint32_t evictions;
+  uint32_t entries;
+  size_t bytes;
+};
+
+err_t page_cache_init(page_cache_t *out, size_t budget,
+                      void (*value_destroy)(void *));
+void page_cache_destroy(page_cache_t *out);
+void *page_cache_get(page_cache_t cache, const struct PageCacheKey *key);
+/**
+   @brief Check presence of the page without touching stats or LRU order.
+*/
+bool page_cache_has(page_cache_t cache, const struct PageCacheKey *key);
+void page_cache_put(page_cache_t cache, const struct PageCacheKey *key,
+                    void *value, size_t size);
+void page_cache_get_stats(page_cache_t cache, struct PageCacheStats *out);
+bool page_cache_key_equal(const struct PageCacheKey *a,
+                          const struct PageCacheKey *b);
+
+#endif // EBOOK_READER_PAGE_CACHE_H
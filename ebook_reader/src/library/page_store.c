@@ -0,0 +1,353 @@
+#include <dirent.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <threads.h>
+#include <unistd.h>
+
+#include "library/page_store.h"
+#include "utils/err.h"
+#include "utils/fs.h"
+#include "utils/log.h"
+#include "utils/mem.h"
+
+#define PAGE_STORE_MAGIC "EBK1"
+#define PAGE_STORE_EXT ".i1"
+
+struct PageStore {
+  mtx_t lock;
+  char *dir;
+  size_t budget;
+  size_t bytes;
+};
+
+/**
+   Header is written in front of every frame. It repeats the whole key, so
+   hash collision of file names is detected on load.
+*/
+struct PageStoreHeader {
+  char magic[4];
+  uint32_t data_len;
+  uint64_t file_id;
+  struct PageCacheKey key;
+};
+
+struct PageStoreFile {
+  char name[32];
+  size_t size;
+  struct timespec mtime;
+};
+
+static void page_store_path(page_store_t store, uint64_t file_id,
+                            const struct PageCacheKey *key, char *buf,
+                            size_t buf_len);
+static uint64_t page_store_hash(uint64_t hash, const void *data, size_t len);
+static struct PageStoreFile *page_store_scan(page_store_t store, int *len);
+static int page_store_file_cmp(const void *a, const void *b);
+static void page_store_prune(page_store_t store);
+
+err_t page_store_init(page_store_t *out, const char *dir, size_t budget) {
+  page_store_t store = *out = mem_malloc(sizeof(struct PageStore));
+  *store = (struct PageStore){
+      .budget = budget,
+  };
+
+  if (mtx_init(&store->lock, mtx_plain) != thrd_success) {
+    err_o = err_errnos(ENOMEM, "Cannot create page store lock");
+    goto error_out;
+  }
+
+  err_o = fs_mkdirs(dir);
+  ERR_TRY_CATCH(err_o, error_lock_cleanup);
+
+  store->dir = strdup(dir);
+
+  int files_len;
+  struct PageStoreFile *files = page_store_scan(store, &files_len);
+  for (int i = 0; i < files_len; i++) {
+    store->bytes += files[i].size;
+  }
+  mem_free(files);
+
+  log_debug("Page store %s: %d pages, %zu bytes", dir, files_len,
+            store->bytes);
+
+  return 0;
+
+error_lock_cleanup:
+  mtx_destroy(&store->lock);
+error_out:
+  mem_free(store);
+  *out = NULL;
+  return err_o;
+}
+
+void page_store_destroy(page_store_t *out) {
+  if (mem_is_null_ptr(out)) {
+    return;
+  }
+
+  page_store_t store = *out;
+  mtx_destroy(&store->lock);
+  mem_free(store->dir);
+  mem_free(store);
+  *out = NULL;
+}
+
+uint64_t page_store_file_id(const char *file_path) {
+  struct stat st;
+  uint64_t id = page_store_hash(0, file_path, strlen(file_path));
+
+  if (stat(file_path, &st) == 0) {
+    int64_t size = st.st_size;
+    int64_t mtime = st.st_mtime;
+    id = page_store_hash(id, &size, sizeof(size));
+    id = page_store_hash(id, &mtime, sizeof(mtime));
+  }
+
+  return id;
+}
+
+bool page_store_has(page_store_t store, uint64_t file_id,
+                    const struct PageCacheKey *key) {
+  char path[PATH_MAX];
+
+  if (!store) {
+    return false;
+  }
+
+  page_store_path(store, file_id, key, path, sizeof(path));
+  return access(path, F_OK) == 0;
+}
+
+bool page_store_load(page_store_t store, uint64_t file_id,
+                     const struct PageCacheKey *key, uint8_t *buf,
+                     size_t buf_len) {
+  struct PageStoreHeader header;
+  char path[PATH_MAX];
+  bool is_loaded = false;
+
+  if (!store) {
+    return false;
+  }
+
+  page_store_path(store, file_id, key, path, sizeof(path));
+
+  mtx_lock(&store->lock);
+  int fd = open(path, O_RDONLY);
+  if (fd == -1) {
+    goto out;
+  }
+
+  if (read(fd, &header, sizeof(header)) != sizeof(header) ||
+      memcmp(header.magic, PAGE_STORE_MAGIC, sizeof(header.magic)) != 0 ||
+      header.file_id != file_id || header.data_len != buf_len ||
+      header.key.page_number != key->page_number ||
+      header.key.scale != key->scale || header.key.x_off != key->x_off ||
+      header.key.y_off != key->y_off || header.key.x != key->x ||
+      header.key.y != key->y) {
+    goto out_close;
+  }
+
+  if (read(fd, buf, buf_len) != (ssize_t)buf_len) {
+    goto out_close;
+  }
+
+  // Modification time orders pages for pruning, SD cards are usually
+  // mounted with noatime so access time cannot be used.
+  futimens(fd, NULL);
+  is_loaded = true;
+
+out_close:
+  close(fd);
+out:
+  mtx_unlock(&store->lock);
+  return is_loaded;
+}
+
+void page_store_save(page_store_t store, uint64_t file_id,
+                     const struct PageCacheKey *key, const uint8_t *buf,
+                     size_t buf_len) {
+  struct PageStoreHeader header;
+  char tmp_path[PATH_MAX + 4];
+  char path[PATH_MAX];
+  struct stat st;
+
+  if (!store) {
+    return;
+  }
+
+  page_store_path(store, file_id, key, path, sizeof(path));
+  snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, PAGE_STORE_MAGIC, sizeof(header.magic));
+  header.data_len = buf_len;
+  header.file_id = file_id;
+  header.key = *key;
+
+  mtx_lock(&store->lock);
+  int fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd == -1) {
+    log_warn("Cannot create %s: %s", tmp_path, strerror(errno));
+    goto out;
+  }
+
+  if (write(fd, &header, sizeof(header)) != sizeof(header) ||
+      write(fd, buf, buf_len) != (ssize_t)buf_len) {
+    log_warn("Cannot write %s: %s", tmp_path, strerror(errno));
+    close(fd);
+    unlink(tmp_path);
+    goto out;
+  }
+  close(fd);
+
+  if (stat(path, &st) == 0) {
+    store->bytes -= st.st_size;
+  }
+
+  // Rename is atomic, power loss never leaves half written page behind.
+  if (rename(tmp_path, path) == -1) {
+    log_warn("Cannot rename %s: %s", tmp_path, strerror(errno));
+    unlink(tmp_path);
+    goto out;
+  }
+
+  store->bytes += sizeof(header) + buf_len;
+  if (store->bytes > store->budget) {
+    page_store_prune(store);
+  }
+
+out:
+  mtx_unlock(&store->lock);
+}
+
+static void page_store_path(page_store_t store, uint64_t file_id,
+                            const struct PageCacheKey *key, char *buf,
+                            size_t buf_len) {
+  uint64_t hash = page_store_hash(file_id, &key->page_number,
+                                  sizeof(key->page_number));
+  hash = page_store_hash(hash, &key->scale, sizeof(key->scale));
+  hash = page_store_hash(hash, &key->x_off, sizeof(key->x_off));
+  hash = page_store_hash(hash, &key->y_off, sizeof(key->y_off));
+  hash = page_store_hash(hash, &key->x, sizeof(key->x));
+  hash = page_store_hash(hash, &key->y, sizeof(key->y));
+
+  snprintf(buf, buf_len, "%s/%016" PRIx64 PAGE_STORE_EXT, store->dir, hash);
+}
+
+/**
+   FNV-1a, `hash` equal to 0 starts a new hash.
+*/
+static uint64_t page_store_hash(uint64_t hash, const void *data, size_t len) {
+  const uint8_t *bytes = data;
+
+  if (hash == 0) {
+    hash = 0xcbf29ce484222325ULL;
+  }
+
+  for (size_t i = 0; i < len; i++) {
+    hash ^= bytes[i];
+    hash *= 0x100000001b3ULL;
+  }
+
+  return hash;
+}
+
+static struct PageStoreFile *page_store_scan(page_store_t store, int *len) {
+  struct PageStoreFile *files = NULL;
+  char path[PATH_MAX];
+  struct dirent *dirent;
+  int files_size = 0;
+  struct stat st;
+
+  *len = 0;
+
+  DIR *dir = opendir(store->dir);
+  if (!dir) {
+    return NULL;
+  }
+
+  while ((dirent = readdir(dir)) != NULL) {
+    const char *ext = strrchr(dirent->d_name, '.');
+    if (!ext || strcmp(ext, PAGE_STORE_EXT) != 0 ||
+        strlen(dirent->d_name) >= sizeof(files->name)) {
+      continue;
+    }
+
+    snprintf(path, sizeof(path), "%s/%s", store->dir, dirent->d_name);
+    if (stat(path, &st) == -1) {
+      continue;
+    }
+
+    if (*len == files_size) {
+      files_size = files_size ? files_size * 2 : 64;
+      struct PageStoreFile *tmp =
+          mem_malloc(sizeof(struct PageStoreFile) * files_size);
+      if (files) {
+        memcpy(tmp, files, sizeof(struct PageStoreFile) * *len);
+        mem_free(files);
+      }
+      files = tmp;
+    }
+
+    struct PageStoreFile *file = &files[(*len)++];
+    memcpy(file->name, dirent->d_name, strlen(dirent->d_name) + 1);
+    file->size = st.st_size;
+    file->mtime = st.st_mtim;
+  }
+
+  closedir(dir);
+
+  return files;
+}
+
+static int page_store_file_cmp(const void *a, const void *b) {
+  const struct PageStoreFile *file_a = a;
+  const struct PageStoreFile *file_b = b;
+
+  if (file_a->mtime.tv_sec != file_b->mtime.tv_sec) {
+    return file_a->mtime.tv_sec < file_b->mtime.tv_sec ? -1 : 1;
+  }
+
+  if (file_a->mtime.tv_nsec != file_b->mtime.tv_nsec) {
+    return file_a->mtime.tv_nsec < file_b->mtime.tv_nsec ? -1 : 1;
+  }
+
+  return 0;
+}
+
+/**
+   Store is pruned down to 3/4 of the budget, so pruning which requires
+   a directory scan does not happen on every save once the store is full.
+*/
+static void page_store_prune(page_store_t store) {
+  char path[PATH_MAX];
+  int files_len;
+
+  struct PageStoreFile *files = page_store_scan(store, &files_len);
+  if (!files) {
+    return;
+  }
+
+  qsort(files, files_len, sizeof(struct PageStoreFile), page_store_file_cmp);
+
+  store->bytes = 0;
+  for (int i = 0; i < files_len; i++) {
+    store->bytes += files[i].size;
+  }
+
+  size_t target = store->budget / 4 * 3;
+  for (int i = 0; i < files_len && store->bytes > target; i++) {
+    snprintf(path, sizeof(path), "%s/%s", store->dir, files[i].name);
+    if (unlink(path) == 0) {
+      store->bytes -= files[i].size;
+    }
+  }
+
+  log_debug("Page store pruned to %zu bytes", store->bytes);
+  mem_free(files);
+}
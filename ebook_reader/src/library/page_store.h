@@ -0,0 +1,49 @@
+#ifndef EBOOK_READER_PAGE_STORE_H
+#define EBOOK_READER_PAGE_STORE_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "library/page_cache.h"
+#include "utils/err.h"
+
+/**
+   Page store keeps rendered pages on disk as 1bpp frames, so they survive
+   reboots. Frames are stored at panel resolution with panel stride, one
+   file per page, and the least recently used files are removed once the
+   store grows over its byte budget.
+
+   Pages are identified by the book file (see `page_store_file_id`) and by
+   the render parameters. All functions are thread safe and accept NULL
+   store, which behaves like an always empty store.
+*/
+
+typedef struct PageStore *page_store_t;
+
+err_t page_store_init(page_store_t *out, const char *dir, size_t budget);
+void page_store_destroy(page_store_t *out);
+
+/**
+   @brief Compute identity of the book file from its path, size and mtime.
+   @note Inode numbers are not stable on FAT formatted cards, so they are
+   not used.
+*/
+uint64_t page_store_file_id(const char *file_path);
+
+/**
+   @brief Load 1bpp frame of the page into `buf` of `buf_len` bytes.
+   @return True if page was found and `buf` is filled, false otherwise.
+*/
+bool page_store_load(page_store_t store, uint64_t file_id,
+                     const struct PageCacheKey *key, uint8_t *buf,
+                     size_t buf_len);
+/**
+   @brief Check if the page is in the store without reading it.
+*/
+bool page_store_has(page_store_t store, uint64_t file_id,
+                    const struct PageCacheKey *key);
+void page_store_save(page_store_t store, uint64_t file_id,
+                     const struct PageCacheKey *key, const uint8_t *buf,
+                     size_t buf_len);
+
+#endif // EBOOK_READER_PAGE_STORE_H
@@ -1,49 +1,168 @@
 #include <assert.h>
-#include <ctype.h>
+#include <fcntl.h>
 #include <libgen.h>
 #include <lvgl.h>
+#include <math.h>
 #include <poppler.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <threads.h>
+#include <unistd.h>
 
 #include "cairo.h"
 #include "library/core.h"
+#include "library/doc_pool.h"
+#include "library/page_cache.h"
+#include "library/page_store.h"
+#include "utils/graphic.h"
 #include "utils/err.h"
+#include "utils/log.h"
 #include "utils/mem.h"
+#include "utils/settings.h"
+
+// Tile of 256x256 ARGB32 pixels takes 256 KiB.
+#define PDF_TILE_SIZE 256
+// Content box is searched on pages rendered at quarter of the panel size.
+#define PDF_CONTENT_BOX_DIVISOR 4
+#define PDF_CONTENT_BOX_SAMPLES 5
+// Mapped file is backed by the page cache and not charged to the document
+// pool. Heap of a parsed document is its xref, catalog and loaded fonts plus
+// page objects and their page tree entries.
+#define PDF_DOC_BASE_BYTES (512 * 1024)
+#define PDF_DOC_PAGE_BYTES (2 * 1024)
 
 typedef struct Pdf *pdf_t;
 typedef struct PdfBook *pdf_book_t;
+typedef struct PdfMapping *pdf_mapping_t;
+typedef struct PdfDoc *pdf_doc_t;
 
 struct Pdf {
   library_t owner;
+  doc_pool_t docs;
+};
+
+/**
+   Document shared by the pool. Poppler documents are not thread safe and
+   two books of the same file, e.g. before and after a rescan, can render on
+   the page and thumbnail workers at once, so every poppler call on the
+   document holds its lock. Document lock is taken last.
+*/
+struct PdfDoc {
+  mtx_t lock;
+  PopplerDocument *doc;
 };
 
+/**
+   Lock guards caches and the rest of the book state and is held only around
+   their access, pages are rendered both by the main loop and by the library
+   worker, and a page in the cache must not wait for one being rendered.
+   Rendering is serialized by `render_lock` instead, document is borrowed
+   from the module's document pool only while it is held, see
+   `pdf_book_open`. Render lock is always taken before the lock.
+
+   Pages are reference counted LVGL I1 images (see `graphic_i1_image_init`),
+   so the same 1bpp frame is rendered, cached, stored and displayed without
+   any conversion.
+*/
 struct PdfBook {
-  cairo_surface_t *thumbnail;
-  cairo_surface_t *page;
+  mtx_t lock;
+  mtx_t render_lock;
+  pdf_doc_t doc;
+  doc_pool_t docs;
+  uint8_t *thumbnail;
+  uint8_t *page;
+  uint8_t *preview;
+  struct PageCacheKey preview_key;
+  page_cache_t pages;
+  // Pieces of pages at display scale, see `pdf_book_compose`.
+  page_cache_t tiles;
+  page_store_t store;
+  uint64_t file_id;
+  bool has_content_box;
+  struct ContentBox content_box;
 };
 
 static err_t book_module_pdf_book_init(book_t);
+static err_t book_module_pdf_book_load(book_t);
 static void book_module_pdf_book_destroy(book_t);
 static const unsigned char *book_module_pdf_book_get_thumbnail(book_t, int,
                                                                int);
 static const unsigned char *book_module_pdf_get_page(book_t book, int x, int y,
                                                      int *buf_len);
+static void book_module_pdf_get_cache_stats(book_t, struct PageCacheStats *);
+static err_t book_module_pdf_render_page(book_t, const struct PageCacheKey *);
+static bool book_module_pdf_has_page(book_t, const struct PageCacheKey *);
+static err_t book_module_pdf_render_preview(book_t,
+                                            const struct PageCacheKey *);
+static const unsigned char *
+book_module_pdf_get_preview(book_t, const struct PageCacheKey *, int *);
+static err_t book_module_pdf_find_content_box(book_t,
+                                              const struct PageCacheKey *);
+static bool book_module_pdf_get_content_box(book_t, struct ContentBox *);
+static err_t book_module_pdf_render_thumbnail(book_t,
+                                              const struct PageCacheKey *);
+static bool book_module_pdf_has_thumbnail(book_t);
 static bool book_module_pdf_is_extension(const char *);
 static void book_module_pdf_destroy(book_module_t);
+static err_t pdf_book_open(book_t);
+static void pdf_book_close(pdf_book_t);
+static void *pdf_doc_ref(void *);
+static GBytes *pdf_book_map(book_t);
+static void pdf_mapping_unmap(void *);
+static void pdf_doc_unref(void *);
+static void pdf_doc_destroy(void *);
+static void pdf_page_destroy(void *);
+static void pdf_tile_destroy(void *);
+static uint8_t *pdf_page_create(const struct PageCacheKey *);
+static uint8_t *pdf_book_load_page(book_t, const struct PageCacheKey *);
+static uint8_t *pdf_book_load_stored_page(pdf_book_t,
+                                          const struct PageCacheKey *);
+static void pdf_book_store_page(pdf_book_t, const struct PageCacheKey *,
+                                uint8_t *);
+static uint8_t *pdf_book_compose(book_t, const struct PageCacheKey *);
+static uint8_t *pdf_book_render_view(book_t, const struct PageCacheKey *);
+static cairo_surface_t *pdf_book_get_tile(book_t, const struct PageCacheKey *,
+                                          int tile_x, int tile_y, int tile_w,
+                                          int tile_h);
+static cairo_surface_t *pdf_book_render(pdf_book_t, int page_no, int x, int y,
+                                        double scale, int area_x, int area_y,
+                                        int area_w, int area_h);
+static cairo_surface_t *pdf_book_render_embedded_thumbnail(pdf_book_t, int x,
+                                                           int y);
 
 err_t book_module_pdf_init(book_module_t module, library_t lib) {
   pdf_t pdf = mem_malloc(sizeof(struct Pdf));
   pdf->owner = lib;
+
+  err_o = doc_pool_init(&pdf->docs, settings_doc_pool_files,
+                        settings_doc_pool_bytes, pdf_doc_ref, pdf_doc_unref);
+  ERR_TRY(err_o);
+
   module->book_init = book_module_pdf_book_init;
+  module->book_load = book_module_pdf_book_load;
   module->book_destroy = book_module_pdf_book_destroy;
   module->book_get_thumbnail = book_module_pdf_book_get_thumbnail;
   module->book_get_page = book_module_pdf_get_page;
+  module->book_get_cache_stats = book_module_pdf_get_cache_stats;
+  module->book_render_page = book_module_pdf_render_page;
+  module->book_has_page = book_module_pdf_has_page;
+  module->book_render_preview = book_module_pdf_render_preview;
+  module->book_get_preview = book_module_pdf_get_preview;
+  module->book_find_content_box = book_module_pdf_find_content_box;
+  module->book_get_content_box = book_module_pdf_get_content_box;
+  module->book_render_thumbnail = book_module_pdf_render_thumbnail;
+  module->book_has_thumbnail = book_module_pdf_has_thumbnail;
   module->is_extension = book_module_pdf_is_extension;
   module->destroy = book_module_pdf_destroy;
   module->private = pdf;
 
   return 0;
+
+error_out:
+  mem_free(pdf);
+  return err_o;
 }
 
 void book_module_pdf_destroy(book_module_t module) {
@@ -51,116 +170,201 @@ void book_module_pdf_destroy(book_module_t module) {
     return;
   }
 
+  pdf_t pdf = module->private;
+  struct DocPoolStats stats;
+  doc_pool_get_stats(pdf->docs, &stats);
+  log_debug("Document pool: hits=%u misses=%u evictions=%u", stats.hits,
+            stats.misses, stats.evictions);
+  doc_pool_destroy(&pdf->docs);
+
   mem_free(module->private);
   module->private = NULL;
 };
 
-static char *pdfinfo_find_field(char *, const char *);
+static char *pdf_book_title_from_path(const char *);
 static err_t book_module_pdf_book_init(book_t book) {
   pdf_book_t pdf_book = book->private = mem_malloc(sizeof(struct PdfBook));
   *pdf_book = (struct PdfBook){0};
 
-  char cmd_buf[4096] = {0};
-  snprintf(cmd_buf, sizeof(cmd_buf), "/usr/bin/pdfinfo %s", book->file_path);
-  FILE *pdfinfo = popen(cmd_buf, "r");
-  if (!pdfinfo) {
+  if (mtx_init(&pdf_book->lock, mtx_plain) != thrd_success) {
+    err_o = err_errnof(ENOMEM, "Cannot create lock for: %s", book->file_path);
     goto error_out;
   }
 
-  fread(cmd_buf, 1, sizeof(cmd_buf), pdfinfo);
-
-  char *title = pdfinfo_find_field(cmd_buf, "Title");
-  if (!title) {
-    err_o = err_errnof(ENODATA, "No title in: %s", book->file_path);
-    goto error_popen_cleanup;
+  if (mtx_init(&pdf_book->render_lock, mtx_plain) != thrd_success) {
+    err_o = err_errnof(ENOMEM, "Cannot create lock for: %s", book->file_path);
+    goto error_lock_cleanup;
   }
 
-  char *pages = pdfinfo_find_field(cmd_buf, "Pages");
-  if (!pages) {
-    err_o = err_errnof(ENODATA, "No pages in: %s", book->file_path);
-    goto error_title_cleanup;
-  }
+  err_o = page_cache_init(&pdf_book->pages, settings_page_cache_bytes,
+                          pdf_page_destroy);
+  ERR_TRY_CATCH(err_o, error_render_lock_cleanup);
 
-  book->title = title;
-  book->max_page_number = atoi(pages);
-  mem_free(pages);
-  pclose(pdfinfo);
+  err_o = page_cache_init(&pdf_book->tiles, settings_tile_cache_bytes,
+                          pdf_tile_destroy);
+  ERR_TRY_CATCH(err_o, error_pages_cleanup);
+
+  pdf_t pdf = library_get_module(book->owner, book->extension)->private;
+  pdf_book->docs = pdf->docs;
+  pdf_book->store = library_get_page_store(book->owner);
+  pdf_book->file_id = page_store_file_id(book->file_path);
 
   return 0;
 
-error_title_cleanup:
-  mem_free(title);
-error_popen_cleanup:
-  pclose(pdfinfo);
+error_pages_cleanup:
+  page_cache_destroy(&pdf_book->pages);
+error_render_lock_cleanup:
+  mtx_destroy(&pdf_book->render_lock);
+error_lock_cleanup:
+  mtx_destroy(&pdf_book->lock);
 error_out:
   mem_free(pdf_book);
+  book->private = NULL;
   return err_o;
 };
 
-static cairo_status_t cairo_read_func(void *closure, unsigned char *data,
-                                      unsigned int length) {
-  fread(data, 1, length, closure);
-
-  return CAIRO_STATUS_SUCCESS;
-}
-
-static const unsigned char *book_module_pdf_book_get_thumbnail(book_t book,
-                                                               int x, int y) {
+static err_t book_module_pdf_book_load(book_t book) {
   pdf_book_t pdf_book = book->private;
-  if (pdf_book->thumbnail) {
-    return cairo_image_surface_get_data(pdf_book->thumbnail);
-  }
 
-  char cmd_buf[4096] = {0};
-  snprintf(
-      cmd_buf, sizeof(cmd_buf),
-      "/usr/bin/pdftoppm -f 0 -l 0 -scale-to-x %d -scale-to-y %d -png -mono %s",
-      x, y, book->file_path);
-  FILE *pdfinfo = popen(cmd_buf, "r");
-  if (!pdfinfo) {
+  mtx_lock(&pdf_book->render_lock);
+  err_o = pdf_book_open(book);
+  ERR_TRY(err_o);
+
+  mtx_lock(&pdf_book->doc->lock);
+  int pages = poppler_document_get_n_pages(pdf_book->doc->doc);
+  char *title = poppler_document_get_title(pdf_book->doc->doc);
+  mtx_unlock(&pdf_book->doc->lock);
+  if (pages < 1) {
+    g_free(title);
+    err_o = err_errnof(ENODATA, "No pages in: %s", book->file_path);
     goto error_out;
   }
 
-  pdf_book->thumbnail =
-      cairo_image_surface_create_from_png_stream(cairo_read_func, pdfinfo);
-
-  unsigned char *thumbnail = cairo_image_surface_get_data(pdf_book->thumbnail);
+  if (title && title[0] != 0) {
+    book->title = strdup(title);
+  } else {
+    book->title = pdf_book_title_from_path(book->file_path);
+  }
+  g_free(title);
 
-  pclose(pdfinfo);
+  book->max_page_number = pages;
+  pdf_book_close(pdf_book);
+  mtx_unlock(&pdf_book->render_lock);
 
-  return thumbnail;
+  return 0;
 
 error_out:
-  return NULL;
+  pdf_book_close(pdf_book);
+  mtx_unlock(&pdf_book->render_lock);
+  return err_o;
 };
 
-static char *pdfinfo_find_field(char *stdout, const char *field_name) {
-  char field_name_deli[strlen(field_name) + 1];
-  snprintf(field_name_deli, sizeof(field_name_deli), "%s:", field_name);
+/**
+   Thumbnails are kept in the page store as 1bpp frames under page number 0,
+   so covers are rendered only once per file version. In memory they are
+   expanded to L8, which LVGL can draw directly.
+*/
+static err_t book_module_pdf_render_thumbnail(book_t book,
+                                              const struct PageCacheKey *key) {
+  pdf_book_t pdf_book = book->private;
+  int x = key->x;
+  int y = key->y;
+  struct PageCacheKey thumbnail_key = {
+      .page_number = 0, .scale = 1, .x = x, .y = y};
+  size_t frame_len = (x + 7) / 8 * y;
 
-  const char *field_start = strstr(stdout, field_name_deli);
-  if (!field_start) {
-    goto error_out;
+  if (book_module_pdf_has_thumbnail(book)) {
+    return 0;
   }
 
-  const char *field_end = strstr(field_start, "\n");
-  if (!field_end) {
-    goto error_out;
+  uint8_t *frame = mem_malloc(frame_len);
+  if (!page_store_load(pdf_book->store, pdf_book->file_id, &thumbnail_key,
+                       frame, frame_len)) {
+    mtx_lock(&pdf_book->render_lock);
+    err_o = pdf_book_open(book);
+    ERR_TRY_CATCH(err_o, error_render_cleanup);
+
+    // Rasterizing the cover is only a fallback, scans are slow to render.
+    cairo_surface_t *cover = pdf_book_render_embedded_thumbnail(pdf_book, x, y);
+    if (!cover) {
+      cover = pdf_book_render(pdf_book, 1, x, y, 1, 0, 0, x, y);
+    }
+    if (!cover) {
+      goto error_render_cleanup;
+    }
+    pdf_book_close(pdf_book);
+    mtx_unlock(&pdf_book->render_lock);
+
+    graphic_argb32_to_i1(frame, x, y, cairo_image_surface_get_data(cover),
+                         cairo_image_surface_get_stride(cover));
+    cairo_surface_destroy(cover);
+    page_store_save(pdf_book->store, pdf_book->file_id, &thumbnail_key,
+                    frame, frame_len);
+  }
+
+  uint8_t *thumbnail = mem_malloc(x * y);
+  graphic_i1_to_l8(thumbnail, x, y, frame);
+  mem_free(frame);
+
+  // Thumbnail of another worker is kept, it could be returned already.
+  mtx_lock(&pdf_book->lock);
+  if (!pdf_book->thumbnail) {
+    pdf_book->thumbnail = thumbnail;
+    thumbnail = NULL;
   }
+  mtx_unlock(&pdf_book->lock);
+  mem_free(thumbnail);
+
+  return 0;
+
+error_render_cleanup:
+  pdf_book_close(pdf_book);
+  mtx_unlock(&pdf_book->render_lock);
+  mem_free(frame);
+  return err_o;
+}
+
+static bool book_module_pdf_has_thumbnail(book_t book) {
+  pdf_book_t pdf_book = book->private;
 
-  field_start += sizeof(field_name_deli);
-  while (isspace(*field_start) && field_start < field_end) {
-    field_start++;
+  mtx_lock(&pdf_book->lock);
+  bool has_thumbnail = pdf_book->thumbnail != NULL;
+  mtx_unlock(&pdf_book->lock);
+
+  return has_thumbnail;
+}
+
+/**
+   Thumbnail is never replaced once it is set, so it can be returned outside
+   of the lock.
+*/
+static const unsigned char *book_module_pdf_book_get_thumbnail(book_t book,
+                                                               int x, int y) {
+  pdf_book_t pdf_book = book->private;
+
+  if (book_module_pdf_render_thumbnail(
+          book, &(struct PageCacheKey){.x = x, .y = y})) {
+    return NULL;
   }
 
-  char *field_value = mem_malloc(field_end - field_start + 1);
-  memset(field_value, 0, field_end - field_start + 1);
-  memcpy(field_value, field_start, field_end - field_start);
+  return pdf_book->thumbnail;
+};
+
+/**
+   Books without Title in Info dictionary are named after the file, without
+   directory and extension.
+*/
+static char *pdf_book_title_from_path(const char *file_path) {
+  char *path = strdup(file_path);
+  char *title = strdup(basename(path));
+  mem_free(path);
 
-  return field_value;
+  char *extension = strrchr(title, '.');
+  if (extension && extension != title) {
+    *extension = 0;
+  }
 
-error_out:
-  return NULL;
+  return title;
 }
 
 static bool book_module_pdf_is_extension(const char *file_path) {
@@ -174,15 +378,25 @@ static void book_module_pdf_book_destroy(book_t book) {
   }
 
   pdf_book_t pdf_book = book->private;
-  if (pdf_book->thumbnail) {
-    cairo_surface_destroy(pdf_book->thumbnail);
-  }
+  mem_free(pdf_book->thumbnail);
 
-  if (pdf_book->page) {
-    cairo_surface_destroy(pdf_book->page);
+  mem_deref(pdf_book->page);
+  mem_deref(pdf_book->preview);
+
+  if (pdf_book->pages) {
+    struct PageCacheStats stats;
+    page_cache_get_stats(pdf_book->pages, &stats);
+    log_debug("Page cache of %s: hits=%u misses=%u evictions=%u",
+              book->file_path, stats.hits, stats.misses, stats.evictions);
+    page_cache_destroy(&pdf_book->pages);
   }
 
-  mem_free((void *)book->title);
+  page_cache_destroy(&pdf_book->tiles);
+
+  pdf_book_close(pdf_book);
+
+  mtx_destroy(&pdf_book->render_lock);
+  mtx_destroy(&pdf_book->lock);
   mem_free(pdf_book);
   book->private = NULL;
 };
@@ -191,41 +405,691 @@ static const unsigned char *book_module_pdf_get_page(book_t book, int x, int y,
                                                      int *buf_len) {
 
   pdf_book_t pdf_book = book->private;
-  if (pdf_book->page) {
-    cairo_surface_destroy(pdf_book->page);
-    pdf_book->page = NULL;
+  struct PageCacheKey key = {
+      .page_number = book->page_number,
+      .scale = book->scale,
+      .x_off = book->x_off,
+      .y_off = book->y_off,
+      .x = x,
+      .y = y,
+  };
+
+  mtx_lock(&pdf_book->lock);
+  pdf_book->page = mem_deref(pdf_book->page);
+
+  // Displayed page holds its own reference, so it stays valid even if the
+  // cache evicts it before the next page is requested.
+  uint8_t *page = page_cache_get(pdf_book->pages, &key);
+  if (page) {
+    pdf_book->page = mem_ref(page);
+  }
+  mtx_unlock(&pdf_book->lock);
+
+  if (!page) {
+    page = pdf_book_load_page(book, &key);
+    if (!page) {
+      return NULL;
+    }
+
+    mtx_lock(&pdf_book->lock);
+    pdf_book->page = page;
+    mtx_unlock(&pdf_book->lock);
+  }
+
+  *buf_len = graphic_i1_image_len(x, y);
+  return page;
+}
+
+static void book_module_pdf_get_cache_stats(book_t book,
+                                            struct PageCacheStats *out) {
+  pdf_book_t pdf_book = book->private;
+  mtx_lock(&pdf_book->lock);
+  page_cache_get_stats(pdf_book->pages, out);
+  mtx_unlock(&pdf_book->lock);
+}
+
+static bool book_module_pdf_has_page(book_t book,
+                                     const struct PageCacheKey *key) {
+  pdf_book_t pdf_book = book->private;
+
+  mtx_lock(&pdf_book->lock);
+  bool has_page = page_cache_has(pdf_book->pages, key);
+  mtx_unlock(&pdf_book->lock);
+
+  return has_page;
+}
+
+static err_t book_module_pdf_render_page(book_t book,
+                                         const struct PageCacheKey *key) {
+  if (book_module_pdf_has_page(book, key)) {
+    return 0;
+  }
+
+  uint8_t *page = pdf_book_load_page(book, key);
+  if (!page) {
+    return err_o;
+  }
+
+  mem_deref(page);
+  return 0;
+}
+
+/**
+   Preview is rendered with resolution divided by `settings_preview_divisor`
+   and stretched back to the page size while it is thresholded. Only the
+   latest preview is kept, it is needed only until the full page is rendered.
+*/
+static err_t book_module_pdf_render_preview(book_t book,
+                                            const struct PageCacheKey *key) {
+  pdf_book_t pdf_book = book->private;
+  int divisor = settings_preview_divisor;
+
+  // Pages which are rendered already are shown faster than any preview.
+  if (book_module_pdf_has_page(book, key) ||
+      page_store_has(pdf_book->store, pdf_book->file_id, key)) {
+    return 0;
+  }
+
+  mtx_lock(&pdf_book->render_lock);
+  err_o = pdf_book_open(book);
+  ERR_TRY(err_o);
+
+  int small_x = key->x / divisor > 0 ? key->x / divisor : 1;
+  int small_y = key->y / divisor > 0 ? key->y / divisor : 1;
+  cairo_surface_t *small = pdf_book_render(
+      pdf_book, key->page_number, small_x, small_y, key->scale,
+      -lround(key->x_off * key->scale / divisor),
+      -lround(key->y_off * key->scale / divisor), small_x, small_y);
+  if (!small) {
+    goto error_out;
+  }
+  pdf_book_close(pdf_book);
+  mtx_unlock(&pdf_book->render_lock);
+
+  uint8_t *preview = pdf_page_create(key);
+  graphic_argb32_scale_to_i1(preview + GRAPHIC_I1_PALETTE_LEN, key->x, key->y,
+                             cairo_image_surface_get_data(small), small_x,
+                             small_y, cairo_image_surface_get_stride(small));
+  cairo_surface_destroy(small);
+
+  mtx_lock(&pdf_book->lock);
+  mem_deref(pdf_book->preview);
+  pdf_book->preview = preview;
+  pdf_book->preview_key = *key;
+  mtx_unlock(&pdf_book->lock);
+
+  return 0;
+
+error_out:
+  pdf_book_close(pdf_book);
+  mtx_unlock(&pdf_book->render_lock);
+  return err_o;
+}
+
+static const unsigned char *
+book_module_pdf_get_preview(book_t book, const struct PageCacheKey *key,
+                            int *buf_len) {
+  pdf_book_t pdf_book = book->private;
+
+  mtx_lock(&pdf_book->lock);
+  if (!pdf_book->preview ||
+      !page_cache_key_equal(&pdf_book->preview_key, key)) {
+    mtx_unlock(&pdf_book->lock);
+    return NULL;
+  }
+
+  // Shown preview is held like a shown page, worker can replace it anytime.
+  mem_deref(pdf_book->page);
+  pdf_book->page = mem_ref(pdf_book->preview);
+  mtx_unlock(&pdf_book->lock);
+
+  *buf_len = graphic_i1_image_len(key->x, key->y);
+  return pdf_book->page;
+}
+
+/**
+   Content box of the document is the union of content boxes of a few pages
+   spread over it, rendered at low resolution. The first page is skipped if
+   possible, covers usually have no margins.
+*/
+static err_t book_module_pdf_find_content_box(book_t book,
+                                              const struct PageCacheKey *key) {
+  pdf_book_t pdf_book = book->private;
+  int small_x = key->x / PDF_CONTENT_BOX_DIVISOR;
+  int small_y = key->y / PDF_CONTENT_BOX_DIVISOR;
+  int box[4] = {small_x, small_y, 0, 0};
+  bool has_box = false;
+  struct ContentBox content_box;
+
+  if (book_module_pdf_get_content_box(book, &content_box)) {
+    return 0;
+  }
+
+  mtx_lock(&pdf_book->render_lock);
+  err_o = pdf_book_open(book);
+  ERR_TRY(err_o);
+
+  int first = book->max_page_number > 2 ? 2 : 1;
+  int samples = book->max_page_number - first + 1;
+  samples = samples < PDF_CONTENT_BOX_SAMPLES ? samples
+                                              : PDF_CONTENT_BOX_SAMPLES;
+
+  for (int i = 0; i < samples; i++) {
+    int page_no = first + i * (book->max_page_number - first + 1) / samples;
+    int page_box[4];
+
+    cairo_surface_t *page = pdf_book_render(
+        pdf_book, page_no, small_x, small_y, 1, 0, 0, small_x, small_y);
+    if (!page) {
+      goto error_out;
+    }
+
+    if (graphic_argb32_content_box(cairo_image_surface_get_data(page),
+                                   small_x, small_y,
+                                   cairo_image_surface_get_stride(page),
+                                   page_box)) {
+      box[0] = page_box[0] < box[0] ? page_box[0] : box[0];
+      box[1] = page_box[1] < box[1] ? page_box[1] : box[1];
+      box[2] = page_box[2] > box[2] ? page_box[2] : box[2];
+      box[3] = page_box[3] > box[3] ? page_box[3] : box[3];
+      has_box = true;
+    }
+    cairo_surface_destroy(page);
+  }
+  pdf_book_close(pdf_book);
+  mtx_unlock(&pdf_book->render_lock);
+
+  // Blank document, there is nothing to fit.
+  if (!has_box) {
+    box[0] = box[1] = 0;
+    box[2] = small_x;
+    box[3] = small_y;
+  }
+
+  // One low resolution pixel of margin is kept around the content.
+  content_box = (struct ContentBox){
+      .left = (float)(box[0] > 0 ? box[0] - 1 : 0) / small_x,
+      .top = (float)(box[1] > 0 ? box[1] - 1 : 0) / small_y,
+      .right = (float)(box[2] < small_x ? box[2] + 1 : small_x) / small_x,
+      .bottom = (float)(box[3] < small_y ? box[3] + 1 : small_y) / small_y,
+  };
+
+  mtx_lock(&pdf_book->lock);
+  pdf_book->content_box = content_box;
+  pdf_book->has_content_box = true;
+  mtx_unlock(&pdf_book->lock);
+
+  return 0;
+
+error_out:
+  pdf_book_close(pdf_book);
+  mtx_unlock(&pdf_book->render_lock);
+  return err_o;
+}
+
+static bool book_module_pdf_get_content_box(book_t book,
+                                            struct ContentBox *out) {
+  pdf_book_t pdf_book = book->private;
+
+  mtx_lock(&pdf_book->lock);
+  bool has_content_box = pdf_book->has_content_box;
+  *out = pdf_book->content_box;
+  mtx_unlock(&pdf_book->lock);
+
+  return has_content_box;
+}
+
+static void pdf_page_destroy(void *page) { mem_deref(page); }
+
+static void pdf_tile_destroy(void *tile) { cairo_surface_destroy(tile); }
+
+static uint8_t *pdf_page_create(const struct PageCacheKey *key) {
+  uint8_t *page = mem_refalloc(graphic_i1_image_len(key->x, key->y), NULL);
+  graphic_i1_image_init(page, key->x, key->y);
+  return page;
+}
+
+/**
+   Load page missing in the memory cache, from the page store if it was
+   rendered before or from the document otherwise, and put it into the memory
+   cache. Caller must not hold any of the book locks and has to release
+   returned reference.
+*/
+static uint8_t *pdf_book_load_page(book_t book,
+                                   const struct PageCacheKey *key) {
+  pdf_book_t pdf_book = book->private;
+
+  uint8_t *page = pdf_book_load_stored_page(pdf_book, key);
+  if (page) {
+    goto out;
   }
 
-  char cmd_buf[4096] = {0};
-  snprintf(cmd_buf, sizeof(cmd_buf),
-           "/usr/bin/pdftoppm -f %d -l %d -scale-to-x %d -scale-to-y %d "
-           "-png -mono %s",
-           book->page_number, book->page_number, (int)(x * book->scale),
-           (int)(y * book->scale), book->file_path);
-  FILE *pdfinfo = popen(cmd_buf, "r");
-  if (!pdfinfo) {
-    err_o = err_errnof(errno, "Cannot execute cmd: %s", cmd_buf);
+  mtx_lock(&pdf_book->render_lock);
+  // The other thread could render the page while this one was waiting.
+  mtx_lock(&pdf_book->lock);
+  if (page_cache_has(pdf_book->pages, key)) {
+    page = mem_ref(page_cache_get(pdf_book->pages, key));
+  }
+  mtx_unlock(&pdf_book->lock);
+  if (page) {
+    mtx_unlock(&pdf_book->render_lock);
+    return page;
+  }
+
+  page = key->scale > 1 ? pdf_book_compose(book, key)
+                        : pdf_book_render_view(book, key);
+  pdf_book_close(pdf_book);
+  mtx_unlock(&pdf_book->render_lock);
+  if (!page) {
+    goto error_out;
+  }
+
+  pdf_book_store_page(pdf_book, key, page);
+
+out:
+  mtx_lock(&pdf_book->lock);
+  page_cache_put(pdf_book->pages, key, mem_ref(page),
+                 graphic_i1_image_len(key->x, key->y));
+  mtx_unlock(&pdf_book->lock);
+  return page;
+
+error_out:
+  return NULL;
+}
+
+/**
+   Zoomed page at display scale is split into square tiles and only tiles
+   visible with current offsets are rendered. Memory is bounded by the view
+   size instead of the zoom, and panning reuses tiles which stay in the view.
+   Tiles are thresholded straight into the page frame, area not covered by
+   the page stays white. Caller has to hold the render lock.
+*/
+static uint8_t *pdf_book_compose(book_t book, const struct PageCacheKey *key) {
+  int raster_x = ceil(key->x * key->scale);
+  int raster_y = ceil(key->y * key->scale);
+  int x_off = lround(key->x_off * key->scale);
+  int y_off = lround(key->y_off * key->scale);
+
+  uint8_t *page = pdf_page_create(key);
+  uint8_t *frame = page + GRAPHIC_I1_PALETTE_LEN;
+
+  int from_x = x_off < 0 ? -x_off : 0;
+  int from_y = y_off < 0 ? -y_off : 0;
+  int to_x = key->x - x_off < raster_x ? key->x - x_off : raster_x;
+  int to_y = key->y - y_off < raster_y ? key->y - y_off : raster_y;
+
+  for (int tile_y = from_y / PDF_TILE_SIZE * PDF_TILE_SIZE; tile_y < to_y;
+       tile_y += PDF_TILE_SIZE) {
+    for (int tile_x = from_x / PDF_TILE_SIZE * PDF_TILE_SIZE; tile_x < to_x;
+         tile_x += PDF_TILE_SIZE) {
+      int tile_w = raster_x - tile_x < PDF_TILE_SIZE ? raster_x - tile_x
+                                                     : PDF_TILE_SIZE;
+      int tile_h = raster_y - tile_y < PDF_TILE_SIZE ? raster_y - tile_y
+                                                     : PDF_TILE_SIZE;
+
+      cairo_surface_t *tile =
+          pdf_book_get_tile(book, key, tile_x, tile_y, tile_w, tile_h);
+      if (!tile) {
+        goto error_out;
+      }
+
+      // Part of the tile inside the view.
+      int left = tile_x < from_x ? from_x : tile_x;
+      int top = tile_y < from_y ? from_y : tile_y;
+      int right = tile_x + tile_w < to_x ? tile_x + tile_w : to_x;
+      int bottom = tile_y + tile_h < to_y ? tile_y + tile_h : to_y;
+      int stride = cairo_image_surface_get_stride(tile);
+
+      graphic_argb32_blit_i1(frame, key->x, left + x_off, top + y_off,
+                             cairo_image_surface_get_data(tile) +
+                                 (top - tile_y) * stride + (left - tile_x) * 4,
+                             right - left, bottom - top, stride);
+      cairo_surface_destroy(tile);
+    }
+  }
+
+  return page;
+
+error_out:
+  mem_deref(page);
+  return NULL;
+}
+
+/**
+   Page which is not zoomed fits the view, so it is rendered in a single pass,
+   tiles would only add per tile setup and blits. Caller has to hold the
+   render lock.
+*/
+static uint8_t *pdf_book_render_view(book_t book,
+                                     const struct PageCacheKey *key) {
+  pdf_book_t pdf_book = book->private;
+
+  err_o = pdf_book_open(book);
+  if (err_o) {
+    return NULL;
+  }
+
+  cairo_surface_t *view = pdf_book_render(
+      pdf_book, key->page_number, key->x, key->y, key->scale,
+      -lround(key->x_off * key->scale), -lround(key->y_off * key->scale),
+      key->x, key->y);
+  if (!view) {
+    return NULL;
+  }
+
+  uint8_t *page = pdf_page_create(key);
+  graphic_argb32_to_i1(page + GRAPHIC_I1_PALETTE_LEN, key->x, key->y,
+                       cairo_image_surface_get_data(view),
+                       cairo_image_surface_get_stride(view));
+  cairo_surface_destroy(view);
+
+  return page;
+}
+
+/**
+   Tiles are cached under the key of the page with tile origin in place of
+   offsets. Caller has to hold the render lock and release returned
+   reference.
+*/
+static cairo_surface_t *pdf_book_get_tile(book_t book,
+                                          const struct PageCacheKey *key,
+                                          int tile_x, int tile_y, int tile_w,
+                                          int tile_h) {
+  pdf_book_t pdf_book = book->private;
+  struct PageCacheKey tile_key = *key;
+  tile_key.x_off = tile_x;
+  tile_key.y_off = tile_y;
+
+  mtx_lock(&pdf_book->lock);
+  cairo_surface_t *tile = page_cache_get(pdf_book->tiles, &tile_key);
+  if (tile) {
+    tile = cairo_surface_reference(tile);
+  }
+  mtx_unlock(&pdf_book->lock);
+  if (tile) {
+    return tile;
+  }
+
+  err_o = pdf_book_open(book);
+  if (err_o) {
+    return NULL;
+  }
+
+  tile = pdf_book_render(pdf_book, key->page_number, key->x, key->y,
+                         key->scale, tile_x, tile_y, tile_w, tile_h);
+  if (!tile) {
+    return NULL;
+  }
+
+  mtx_lock(&pdf_book->lock);
+  page_cache_put(pdf_book->tiles, &tile_key, cairo_surface_reference(tile),
+                 cairo_image_surface_get_stride(tile) * tile_h);
+  mtx_unlock(&pdf_book->lock);
+  return tile;
+}
+
+static uint8_t *pdf_book_load_stored_page(pdf_book_t pdf_book,
+                                          const struct PageCacheKey *key) {
+  if (!pdf_book->store) {
+    return NULL;
+  }
+
+  uint8_t *page = pdf_page_create(key);
+  if (!page_store_load(pdf_book->store, pdf_book->file_id, key,
+                       page + GRAPHIC_I1_PALETTE_LEN,
+                       graphic_i1_image_len(key->x, key->y) -
+                           GRAPHIC_I1_PALETTE_LEN)) {
+    mem_deref(page);
+    return NULL;
+  }
+
+  return page;
+}
+
+static void pdf_book_store_page(pdf_book_t pdf_book,
+                                const struct PageCacheKey *key,
+                                uint8_t *page) {
+  page_store_save(pdf_book->store, pdf_book->file_id, key,
+                  page + GRAPHIC_I1_PALETTE_LEN,
+                  graphic_i1_image_len(key->x, key->y) -
+                      GRAPHIC_I1_PALETTE_LEN);
+}
+
+/**
+   Parsed documents are kept in the document pool shared by all books, so
+   page turns, thumbnails and prefetches, or going back to a recently read
+   book, do not pay for parsing the PDF again. Pool is bounded, so books do
+   not hold their documents, each one is released by `pdf_book_close`
+   before the book's render lock is.
+*/
+static err_t pdf_book_open(book_t book) {
+  pdf_book_t pdf_book = book->private;
+  GError *gerr = NULL;
+
+  if (pdf_book->doc) {
+    return 0;
+  }
+
+  pdf_book->doc = doc_pool_get(pdf_book->docs, pdf_book->file_id);
+  if (pdf_book->doc) {
+    return 0;
+  }
+
+  GBytes *bytes = pdf_book_map(book);
+  if (!bytes) {
+    return err_o;
+  }
+
+  // Document keeps its own reference of the mapping.
+  PopplerDocument *doc = poppler_document_new_from_bytes(bytes, NULL, &gerr);
+  g_bytes_unref(bytes);
+  if (!doc) {
+    err_o = err_errnof(EINVAL, "Cannot open %s: %s", book->file_path,
+                       gerr->message);
+    goto error_out;
+  }
+
+  pdf_doc_t pdf_doc = mem_refalloc(sizeof(struct PdfDoc), pdf_doc_destroy);
+  *pdf_doc = (struct PdfDoc){.doc = doc};
+  if (mtx_init(&pdf_doc->lock, mtx_plain) != thrd_success) {
+    err_o = err_errnof(ENOMEM, "Cannot create lock for: %s", book->file_path);
+    pdf_doc->doc = NULL;
+    mem_deref(pdf_doc);
+    g_object_unref(doc);
+    goto error_out;
+  }
+  pdf_book->doc = pdf_doc;
+
+  // Document is not shared yet, so its lock is not needed.
+  size_t pages = poppler_document_get_n_pages(doc);
+  doc_pool_put(pdf_book->docs, pdf_book->file_id, pdf_book->doc,
+               PDF_DOC_BASE_BYTES + pages * PDF_DOC_PAGE_BYTES);
+
+  return 0;
+
+error_out:
+  g_clear_error(&gerr);
+  return err_o;
+}
+
+static void pdf_book_close(pdf_book_t pdf_book) {
+  if (!pdf_book->doc) {
+    return;
+  }
+
+  pdf_book->doc = mem_deref(pdf_book->doc);
+}
+
+/**
+   Mapping of a book file, unmapped once the last document using it is
+   closed.
+*/
+struct PdfMapping {
+  void *addr;
+  size_t len;
+};
+
+/**
+   Files are mapped instead of read, so a large scanned book costs only the
+   pages of the file poppler actually touches, and those live in the kernel
+   page cache, which can drop them under memory pressure and keeps them for
+   the next open. Poppler jumps between xref, objects and streams, so
+   read-ahead is disabled.
+*/
+static GBytes *pdf_book_map(book_t book) {
+  struct stat st;
+
+  int fd = open(book->file_path, O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
+    err_o = err_errnof(errno, "Cannot open %s", book->file_path);
+    goto error_out;
+  }
+
+  if (fstat(fd, &st) == -1) {
+    err_o = err_errnof(errno, "Cannot stat %s", book->file_path);
+    goto error_fd_cleanup;
+  }
+
+  if (st.st_size == 0) {
+    err_o = err_errnof(ENODATA, "Empty file: %s", book->file_path);
+    goto error_fd_cleanup;
+  }
+
+  void *addr = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (addr == MAP_FAILED) {
+    err_o = err_errnof(errno, "Cannot map %s", book->file_path);
+    goto error_fd_cleanup;
+  }
+  close(fd);
+
+  if (madvise(addr, st.st_size, MADV_RANDOM) == -1) {
+    log_warn("Cannot advise random access to %s", book->file_path);
+  }
+
+  pdf_mapping_t mapping = mem_malloc(sizeof(struct PdfMapping));
+  *mapping = (struct PdfMapping){.addr = addr, .len = st.st_size};
+
+  return g_bytes_new_with_free_func(addr, st.st_size, pdf_mapping_unmap,
+                                    mapping);
+
+error_fd_cleanup:
+  close(fd);
+error_out:
+  return NULL;
+}
+
+static void pdf_mapping_unmap(void *data) {
+  pdf_mapping_t mapping = data;
+  munmap(mapping->addr, mapping->len);
+  mem_free(mapping);
+}
+
+static void *pdf_doc_ref(void *doc) { return mem_ref(doc); }
+
+static void pdf_doc_unref(void *doc) { mem_deref(doc); }
+
+static void pdf_doc_destroy(void *data) {
+  pdf_doc_t pdf_doc = data;
+
+  if (!pdf_doc->doc) {
+    return;
+  }
+
+  g_object_unref(pdf_doc->doc);
+  mtx_destroy(&pdf_doc->lock);
+}
+
+/**
+   Render `area_w`x`area_h` area of the page, which is stretched to
+   `x*scale`x`y*scale`, the same way pdftoppm `-scale-to-x`/`-scale-to-y`
+   output used to be scaled.
+*/
+static cairo_surface_t *pdf_book_render(pdf_book_t pdf_book, int page_no, int x,
+                                        int y, double scale, int area_x,
+                                        int area_y, int area_w, int area_h) {
+  double page_x, page_y;
+
+  mtx_lock(&pdf_book->doc->lock);
+  PopplerPage *page =
+      poppler_document_get_page(pdf_book->doc->doc, page_no - 1);
+  if (!page) {
+    err_o = err_errnof(EINVAL, "No page %d in document", page_no);
     goto error_out;
   }
 
   cairo_surface_t *surface =
-      cairo_image_surface_create_from_png_stream(cairo_read_func, pdfinfo);
+      cairo_image_surface_create(CAIRO_FORMAT_ARGB32, area_w, area_h);
+  if (cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS) {
+    err_o = err_errnof(ENOMEM, "Cannot create %dx%d surface", area_w, area_h);
+    goto error_page_cleanup;
+  }
 
-  pdf_book->page = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, x, y);
-  cairo_t *cr = cairo_create(pdf_book->page);
-  cairo_set_source_surface(cr, surface, book->x_off * book->scale,
-                           book->y_off * book->scale);
+  poppler_page_get_size(page, &page_x, &page_y);
+
+  // Poppler draws only page content, background has to be painted by us.
+  // Area not covered by the page is white as well.
+  cairo_t *cr = cairo_create(surface);
+  cairo_set_source_rgb(cr, 1, 1, 1);
   cairo_paint(cr);
 
-  unsigned char *page = cairo_image_surface_get_data(pdf_book->page);
-  *buf_len = x * y * 4; // ARGB pixel size is 4 bytes
+  cairo_translate(cr, -area_x, -area_y);
+  cairo_scale(cr, x * scale / page_x, y * scale / page_y);
 
-  pclose(pdfinfo);
-  cairo_surface_destroy(surface);
+  poppler_page_render(page, cr);
   cairo_destroy(cr);
+  cairo_surface_flush(surface);
+  g_object_unref(page);
+  mtx_unlock(&pdf_book->doc->lock);
 
-  return page;
+  return surface;
 
+error_page_cleanup:
+  cairo_surface_destroy(surface);
+  g_object_unref(page);
 error_out:
+  mtx_unlock(&pdf_book->doc->lock);
   return NULL;
 }
+
+/**
+   Thumbnail embedded in the document (/Thumb of the first page) is
+   stretched to `x`x`y`, the same way the page is by `pdf_book_render`.
+   @return NULL if the first page has no embedded thumbnail.
+*/
+static cairo_surface_t *pdf_book_render_embedded_thumbnail(pdf_book_t pdf_book,
+                                                           int x, int y) {
+  mtx_lock(&pdf_book->doc->lock);
+  PopplerPage *page = poppler_document_get_page(pdf_book->doc->doc, 0);
+  cairo_surface_t *thumb = page ? poppler_page_get_thumbnail(page) : NULL;
+  if (page) {
+    g_object_unref(page);
+  }
+  mtx_unlock(&pdf_book->doc->lock);
+  if (!thumb) {
+    return NULL;
+  }
+
+  int thumb_x = cairo_image_surface_get_width(thumb);
+  int thumb_y = cairo_image_surface_get_height(thumb);
+  cairo_surface_t *surface =
+      cairo_image_surface_create(CAIRO_FORMAT_ARGB32, x, y);
+  if (thumb_x < 1 || thumb_y < 1 ||
+      cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS) {
+    cairo_surface_destroy(surface);
+    cairo_surface_destroy(thumb);
+    return NULL;
+  }
+
+  // Background is white, as for rendered pages, in case of transparency.
+  cairo_t *cr = cairo_create(surface);
+  cairo_set_source_rgb(cr, 1, 1, 1);
+  cairo_paint(cr);
+  cairo_scale(cr, (double)x / thumb_x, (double)y / thumb_y);
+  cairo_set_source_surface(cr, thumb, 0, 0);
+  cairo_paint(cr);
+  cairo_destroy(cr);
+  cairo_surface_flush(surface);
+  cairo_surface_destroy(thumb);
+
+  return surface;
+}
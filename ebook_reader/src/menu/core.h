@@ -16,13 +16,19 @@ struct MenuView {
 };
 
 err_t menu_view_init(struct MenuView *view, books_list_t books,
-                     void (*book_cb)(book_t, void *), void *data);
+                     void (*book_cb)(book_t, void *), void *data,
+                     void (*thumbnail_cb)(book_t, void *),
+                     void *thumbnail_data);
 void menu_view_destroy(struct MenuView *view);
+void menu_view_show_thumbnail(struct MenuView *view, book_t book);
 
 err_t wdgt_bar_init(wdgt_bar_t *out);
 void wdgt_bar_destroy(wdgt_bar_t *out);
 err_t wdgt_books_init(wdgt_books_t *out, books_list_t books,
-                      void (*event_cb)(book_t, void *), void *event_data);
+                      void (*event_cb)(book_t, void *), void *event_data,
+                      void (*thumbnail_cb)(book_t, void *),
+                      void *thumbnail_data);
 void wdgt_books_destroy(wdgt_books_t *out);
+void wdgt_books_show_thumbnail(wdgt_books_t books, book_t book);
 
 #endif // EBOOK_READER_MENU_CORE_H
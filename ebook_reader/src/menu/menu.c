@@ -29,10 +29,13 @@ struct MenuTransition {
 
 static void menu_activate(enum Events __, ref_t ___, void *sub_data);
 static void menu_deactivate(enum Events __, ref_t ___, void *sub_data);
+static void menu_refresh(enum Events __, ref_t ___, void *sub_data);
+static void menu_show_thumbnail(enum Events __, ref_t book, void *sub_data);
 static void menu_post_event(enum Events event, ref_t event_data,
                             void *sub_data);
 static const char *menu_state_dump(enum MenuStates state);
 static void select_book_cb(book_t, void *);
+static void thumbnail_ready_cb(book_t, void *);
 
 struct MenuTransition menu_fsm_table[MenuStates_MAX][Events_MAX] = {
     [MenuStates_NONE] =
@@ -55,6 +58,16 @@ struct MenuTransition menu_fsm_table[MenuStates_MAX][Events_MAX] = {
                     .next_state = MenuStates_NONE,
                     .action = menu_deactivate,
                 },
+            [Events_LIBRARY_UPDATED] =
+                {
+                    .next_state = MenuStates_ACTIVE,
+                    .action = menu_refresh,
+                },
+            [Events_BOOK_THUMBNAIL_READY] =
+                {
+                    .next_state = MenuStates_ACTIVE,
+                    .action = menu_show_thumbnail,
+                },
         },
 
 };
@@ -97,7 +110,8 @@ static void menu_activate(enum Events __, ref_t ___, void *sub_data) {
   menu_t menu = sub_data;
 
   books_list_t books = library_list_books(menu->library);
-  err_o = menu_view_init(&menu->view, books, select_book_cb, menu);
+  err_o = menu_view_init(&menu->view, books, select_book_cb, menu,
+                         thumbnail_ready_cb, menu->evqueue);
   ERR_TRY(err_o);
 
   display_add_to_ingroup(menu->display, menu->view.books);
@@ -116,14 +130,39 @@ static void select_book_cb(book_t book, void *sub_data) {
   event_queue_push(menu->evqueue, Events_BOOK_OPENED, book);
 };
 
+/**
+   Called from a thumbnail worker. Event queue outlives the library, unlike
+   the menu.
+*/
+static void thumbnail_ready_cb(book_t book, void *data) {
+  event_queue_t evqueue = data;
+  event_queue_push(evqueue, Events_BOOK_THUMBNAIL_READY, book);
+}
+
+static void menu_show_thumbnail(enum Events __, ref_t book, void *sub_data) {
+  menu_t menu = sub_data;
+  menu_view_show_thumbnail(&menu->view, book);
+}
+
 static void menu_deactivate(enum Events __, ref_t ___, void *sub_data) {
 
   menu_t menu = sub_data;
 
+  // Covers of a hidden menu would only delay the reader.
+  library_cancel_thumbnails(menu->library);
   display_del_from_ingroup(menu->display, menu->view.books);
   menu_view_destroy(&menu->view);
 };
 
+/**
+   Hidden menu lists books again on its next activation, only the shown one
+   has to be rebuilt.
+*/
+static void menu_refresh(enum Events __, ref_t ___, void *sub_data) {
+  menu_deactivate(Events_NONE, NULL, sub_data);
+  menu_activate(Events_NONE, NULL, sub_data);
+}
+
 static void menu_post_event(enum Events event, ref_t event_data,
                             void *sub_data) {
 
@@ -4,7 +4,9 @@
 #include "utils/mem.h"
 
 err_t menu_view_init(struct MenuView *view, books_list_t books,
-                     void (*book_cb)(book_t, void *), void *data) {
+                     void (*book_cb)(book_t, void *), void *data,
+                     void (*thumbnail_cb)(book_t, void *),
+                     void *thumbnail_data) {
   err_o = wdgt_bar_init(&view->bar);
   ERR_TRY(err_o);
 
@@ -12,7 +14,8 @@ err_t menu_view_init(struct MenuView *view, books_list_t books,
     goto out;
   }
 
-  err_o = wdgt_books_init(&view->books, books, book_cb, data);
+  err_o = wdgt_books_init(&view->books, books, book_cb, data, thumbnail_cb,
+                          thumbnail_data);
   ERR_TRY_CATCH(err_o, error_bar_cleanup);
 
 out:
@@ -25,6 +28,14 @@ error_out:
   return err_o;
 }
 
+void menu_view_show_thumbnail(struct MenuView *view, book_t book) {
+  if (!view->books) {
+    return;
+  }
+
+  wdgt_books_show_thumbnail(view->books, book);
+}
+
 void menu_view_destroy(struct MenuView *view) {
   wdgt_bar_destroy(&view->bar);
   wdgt_books_destroy(&view->books);
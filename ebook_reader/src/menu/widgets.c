@@ -9,13 +9,27 @@
 
 typedef lvgl_obj_t wdgt_book_t;
 
+/**
+   Cards are created in batches, starting with the ones which fit on screen.
+   Next batch is created when focus reaches the last row of cards, so the
+   menu costs the same no matter how many books are in the library.
+
+   Thumbnails are rendered by the library's thumbnail workers, cards show an
+   empty frame until `wdgt_books_show_thumbnail` fills it in.
+*/
 struct WdgtBooks {
   void (*event_cb)(book_t, void *);
   void *event_data;
+  void (*thumbnail_cb)(book_t, void *);
+  void *thumbnail_data;
 
+  lv_obj_t *container;
   lv_style_t *books_style;
+  books_list_t books;
   wdgt_book_t *books_arr;
   int books_arr_len;
+  int books_per_row;
+  int books_per_batch;
 };
 
 struct WdgtBook {
@@ -36,7 +50,11 @@ static wdgt_book_t wdgt_book_create(wdgt_books_t books, const char *book_title,
                                     bool is_focused, const uint8_t *thumbnail,
                                     ref_t data);
 static void wdgt_book_destroy(wdgt_book_t book);
+static void wdgt_book_set_thumbnail(struct WdgtBook *wdgt,
+                                    const uint8_t *thumbnail);
 static void wdgt_book_event_cb(lv_event_t *e);
+static void wdgt_book_focus_cb(lv_event_t *e);
+static void wdgt_books_fill(struct WdgtBooks *books_priv);
 
 err_t wdgt_bar_init(wdgt_bar_t *out) {
   lv_obj_t *bar = lvgl_obj_create(lv_screen_active());
@@ -98,7 +116,9 @@ void wdgt_bar_destroy(wdgt_bar_t *out) {
 };
 
 err_t wdgt_books_init(wdgt_books_t *out, books_list_t books,
-                      void (*event_cb)(book_t, void *), void *event_data) {
+                      void (*event_cb)(book_t, void *), void *event_data,
+                      void (*thumbnail_cb)(book_t, void *),
+                      void *thumbnail_data) {
   struct WdgtBooks *books_priv = mem_malloc(sizeof(struct WdgtBooks));
   lv_obj_t *books_container = *out = lvgl_obj_create(lv_screen_active());
   lv_gridnav_add(books_container, LV_GRIDNAV_CTRL_NONE);
@@ -126,32 +146,78 @@ err_t wdgt_books_init(wdgt_books_t *out, books_list_t books,
   lv_style_set_bg_color(style, lv_color_white());
   lv_obj_add_style(books_container, style, LV_PART_MAIN | LV_STATE_DEFAULT);
 
-  wdgt_book_t *lv_books =
-      mem_malloc(sizeof(wdgt_book_t) * books_list_len(books));
-  wdgt_book_t lv_book = NULL;
-  int i = 0;
-
-  for (book_t book = books_list_get(books); book != NULL;
-       book = books_list_get(books)) {
-    lv_book = wdgt_book_create(
-        books_container, book_get_title(book), lv_book == NULL,
-        book_get_thumbnail(book, book_x, book_y - book_text_y), book);
-    lv_obj_add_event_cb(lv_book, wdgt_book_event_cb, LV_EVENT_KEY, books_priv);
-
-    lv_books[i++] = lv_book;
-  }
+  // One more row than fits on screen, the last one is partially visible.
+  int books_per_row = (books_x + 96) / (book_x + 16 + 96);
+  books_per_row = books_per_row > 0 ? books_per_row : 1;
+  int rows = books_y / (book_y + 16 + 48) + 1;
 
   *books_priv = (struct WdgtBooks){
       .event_data = event_data,
-      .books_arr = lv_books,
       .event_cb = event_cb,
+      .thumbnail_cb = thumbnail_cb,
+      .thumbnail_data = thumbnail_data,
+      .container = books_container,
       .books_style = style,
-      .books_arr_len = i,
+      .books = books,
+      .books_arr = mem_malloc(sizeof(wdgt_book_t) *
+                              (books_list_len(books) ? books_list_len(books)
+                                                     : 1)),
+      .books_per_row = books_per_row,
+      .books_per_batch = books_per_row * rows,
   };
 
+  wdgt_books_fill(books_priv);
+
   return 0;
 }
 
+/**
+   Title and thumbnail of a book are resolved by the library on first use,
+   so only books which get a card are ever loaded by the menu.
+*/
+static void wdgt_books_fill(struct WdgtBooks *books_priv) {
+  for (int i = 0; i < books_priv->books_per_batch; i++) {
+    book_t book = books_list_get(books_priv->books);
+    if (!book) {
+      return;
+    }
+
+    const uint8_t *thumbnail = NULL;
+    if (book_request_thumbnail(book, book_x, book_y - book_text_y,
+                               books_priv->thumbnail_cb,
+                               books_priv->thumbnail_data)) {
+      thumbnail = book_get_thumbnail(book, book_x, book_y - book_text_y);
+    }
+
+    wdgt_book_t lv_book =
+        wdgt_book_create(books_priv->container, book_get_title(book),
+                         books_priv->books_arr_len == 0, thumbnail, book);
+    lv_obj_add_event_cb(lv_book, wdgt_book_event_cb, LV_EVENT_KEY, books_priv);
+    lv_obj_add_event_cb(lv_book, wdgt_book_focus_cb, LV_EVENT_FOCUSED,
+                        books_priv);
+
+    books_priv->books_arr[books_priv->books_arr_len++] = lv_book;
+  }
+}
+
+/**
+   Thumbnail may arrive for a book of an older list, it has no card then.
+*/
+void wdgt_books_show_thumbnail(wdgt_books_t books, book_t book) {
+  struct WdgtBooks *books_priv = lv_obj_get_user_data(books);
+
+  for (int i = 0; i < books_priv->books_arr_len; i++) {
+    struct WdgtBook *wdgt = lv_obj_get_user_data(books_priv->books_arr[i]);
+    if (wdgt->user_data != book) {
+      continue;
+    }
+
+    wdgt_book_set_thumbnail(
+        wdgt, book_get_thumbnail(book, book_x, book_y - book_text_y));
+    return;
+  }
+}
+
 void wdgt_books_destroy(wdgt_books_t *out) {
   if (mem_is_null_ptr(out)) {
     return;
@@ -182,26 +248,15 @@ static wdgt_book_t wdgt_book_create(wdgt_books_t books, const char *book_title,
                                     ref_t data) {
   struct WdgtBook *wdgt = mem_malloc(sizeof(struct WdgtBook));
   lv_obj_t *book_card = lvgl_obj_create(books);
-  lv_obj_t *book_img = NULL;
 
   lv_obj_set_size(book_card, book_x + 16, book_y + 16);
   lv_obj_set_user_data(book_card, wdgt);
 
-  // Configure data required to display book
-  if (thumbnail) {
-    book_img = lv_image_create(book_card);
-    lv_img_dsc_t *dsc = mem_malloc(sizeof(lv_image_dsc_t));
-    *dsc = (lv_img_dsc_t){0};
-    dsc->header.cf = LV_COLOR_FORMAT_ARGB8888_PREMULTIPLIED;
-    dsc->header.w = book_x;
-    dsc->header.h = (book_y - book_text_y);
-    dsc->data_size = dsc->header.w * dsc->header.h * 4;
-    dsc->data = thumbnail;
-    lv_image_set_src(book_img, dsc);
-    lv_obj_set_style_border_width(book_img, 2, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_clear_flag(book_img, LV_OBJ_FLAG_CLICK_FOCUSABLE);
-    lv_obj_set_user_data(book_img, dsc);
-  }
+  // Empty frame is a placeholder until the thumbnail is rendered
+  lv_obj_t *book_img = lv_image_create(book_card);
+  lv_obj_set_size(book_img, book_x, book_y - book_text_y);
+  lv_obj_set_style_border_width(book_img, 2, LV_PART_MAIN | LV_STATE_DEFAULT);
+  lv_obj_clear_flag(book_img, LV_OBJ_FLAG_CLICK_FOCUSABLE);
 
   // Configure book label
   lv_obj_t *book_label = lv_label_create(book_card);
@@ -232,15 +287,34 @@ static wdgt_book_t wdgt_book_create(wdgt_books_t books, const char *book_title,
       .label = book_label,
       .user_data = mem_ref(data),
   };
+  wdgt_book_set_thumbnail(wdgt, thumbnail);
 
   return book_card;
 }
 
+static void wdgt_book_set_thumbnail(struct WdgtBook *wdgt,
+                                    const uint8_t *thumbnail) {
+  // Books which cannot be loaded keep the placeholder.
+  if (!thumbnail || lv_obj_get_user_data(wdgt->img)) {
+    return;
+  }
+
+  lv_img_dsc_t *dsc = mem_malloc(sizeof(lv_image_dsc_t));
+  *dsc = (lv_img_dsc_t){0};
+  dsc->header.cf = LV_COLOR_FORMAT_L8;
+  dsc->header.w = book_x;
+  dsc->header.h = (book_y - book_text_y);
+  dsc->data_size = dsc->header.w * dsc->header.h;
+  dsc->data = thumbnail;
+  lv_image_set_src(wdgt->img, dsc);
+  lv_obj_set_user_data(wdgt->img, dsc);
+}
+
 static void wdgt_book_destroy(wdgt_book_t book) {
   struct WdgtBook *wdgt = lv_obj_get_user_data(book);
-  void *book_img = lv_obj_get_user_data(wdgt->img);
   mem_deref(wdgt->user_data);
   lv_obj_del(wdgt->label);
+  void *book_img = lv_obj_get_user_data(wdgt->img);
   lv_obj_del(wdgt->img);
   mem_free(book_img);
   lv_obj_del(book);
@@ -257,3 +331,13 @@ static void wdgt_book_event_cb(lv_event_t *e) {
     books->event_cb(wdgt->user_data, books->event_data);
   }
 }
+
+static void wdgt_book_focus_cb(lv_event_t *e) {
+  struct WdgtBooks *books = lv_event_get_user_data(e);
+  wdgt_book_t wx = lv_event_get_current_target(e);
+
+  if ((int)lv_obj_get_index(wx) + books->books_per_row >=
+      books->books_arr_len) {
+    wdgt_books_fill(books);
+  }
+}
@@ -19,11 +19,17 @@ struct ReaderView {
   wdgt_page_t page;
   book_t book;
   struct ReaderViewBook last_book;
+  struct ReaderViewBook last_preview;
   void (*next_page_cb)(void *);
   void (*prev_page_cb)(void *);
   void (*book_settings_cb)(void *);
   void (*menu_cb)(void *);
   void *cb_data;
+  // Page turns waiting for the end of their burst.
+  lvgl_timer_t turn_timer;
+  int turn_delta;
+  void (*turn_cb)(int delta, void *);
+  void *turn_data;
 };
 
 err_t reader_view_init(struct ReaderView *view, book_t book,
@@ -32,6 +38,12 @@ err_t reader_view_init(struct ReaderView *view, book_t book,
                        void (*book_settings_cb)(void *), void *data);
 void reader_view_destroy(struct ReaderView *view);
 err_t reader_view_refresh(struct ReaderView *view);
+void reader_view_request_page(struct ReaderView *view,
+                              void (*on_ready)(book_t, void *), void *data);
+bool reader_view_auto_crop(book_t book, void (*on_ready)(book_t, void *),
+                           void *data);
+void reader_view_turn_page(struct ReaderView *view, int delta,
+                           void (*turn_cb)(int delta, void *), void *data);
 
 err_t wdgt_page_init(wdgt_page_t *out, const unsigned char *page_data,
                      int page_size, void (*cb)(lvgl_event_t), void *data);
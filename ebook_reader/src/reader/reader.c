@@ -35,6 +35,8 @@ static void reader_prev_page(enum Events __, ref_t ___, void *sub_data);
 static void reader_put_in_bg(enum Events __, ref_t ___, void *sub_data);
 static void reader_put_in_fg(enum Events __, ref_t ___, void *sub_data);
 static void reader_refresh(enum Events __, ref_t ___, void *sub_data);
+static void reader_request_page(enum Events __, ref_t ___, void *sub_data);
+static void reader_crop(enum Events __, ref_t book, void *sub_data);
 static void reader_post_event(enum Events event, ref_t event_data,
                               void *sub_data);
 static const char *reader_state_dump(enum ReaderStates state);
@@ -42,6 +44,9 @@ static void next_page_cb(void *);
 static void prev_page_cb(void *);
 static void menu_cb(void *);
 static void book_settings_cb(void *);
+static void page_ready_cb(book_t, void *);
+static void turn_page_cb(int delta, void *);
+static void crop_ready_cb(book_t, void *);
 
 struct ReaderTransition reader_fsm_table[ReaderStates_MAX][Events_MAX] = {
     [ReaderStates_NONE] =
@@ -65,10 +70,20 @@ struct ReaderTransition reader_fsm_table[ReaderStates_MAX][Events_MAX] = {
                     .action = reader_prev_page,
                 },
             [Events_BOOK_UPDATED] =
+                {
+                    .next_state = ReaderStates_ACTIVE,
+                    .action = reader_request_page,
+                },
+            [Events_BOOK_PAGE_READY] =
                 {
                     .next_state = ReaderStates_ACTIVE,
                     .action = reader_refresh,
                 },
+            [Events_BOOK_CROP_READY] =
+                {
+                    .next_state = ReaderStates_ACTIVE,
+                    .action = reader_crop,
+                },
             [Events_BOOK_CLOSED] =
                 {
                     .next_state = ReaderStates_NONE,
@@ -88,10 +103,20 @@ struct ReaderTransition reader_fsm_table[ReaderStates_MAX][Events_MAX] = {
     [ReaderStates_BACKGROUND] =
         {
             [Events_BOOK_UPDATED] =
+                {
+                    .next_state = ReaderStates_BACKGROUND,
+                    .action = reader_request_page,
+                },
+            [Events_BOOK_PAGE_READY] =
                 {
                     .next_state = ReaderStates_BACKGROUND,
                     .action = reader_refresh,
                 },
+            [Events_BOOK_CROP_READY] =
+                {
+                    .next_state = ReaderStates_BACKGROUND,
+                    .action = reader_crop,
+                },
             [Events_BOOK_SETTINGS_CLOSED] =
                 {
                     .next_state = ReaderStates_ACTIVE,
@@ -175,6 +200,9 @@ static void reader_activate(enum Events __, ref_t arg, void *sub_data) {
   reader_t reader = sub_data;
   book_t book = arg;
 
+  // Known content box is applied before the first render of the book.
+  reader_view_auto_crop(book, crop_ready_cb, reader->evqueue);
+
   err_o = reader_view_init(&reader->view, book, next_page_cb, prev_page_cb,
                            menu_cb, book_settings_cb, reader);
   ERR_TRY(err_o);
@@ -226,19 +254,23 @@ static void book_settings_cb(void *out) {
 
 static void reader_next_page(enum Events __, ref_t ___, void *sub_data) {
   reader_t reader = sub_data;
-
-  int page_no = book_get_page_no(reader->view.book);
-  page_no++;
-  book_set_page_no(reader->view.book, page_no);
-
-  event_queue_push(reader->evqueue, Events_BOOK_UPDATED, reader->view.book);
+  reader_view_turn_page(&reader->view, 1, turn_page_cb, reader);
 }
 
 static void reader_prev_page(enum Events __, ref_t ___, void *sub_data) {
   reader_t reader = sub_data;
+  reader_view_turn_page(&reader->view, -1, turn_page_cb, reader);
+}
+
+/**
+   Called for the first page turn right away, then with the net delta of
+   turns merged within each window.
+*/
+static void turn_page_cb(int delta, void *data) {
+  reader_t reader = data;
 
   int page_no = book_get_page_no(reader->view.book);
-  page_no--;
+  page_no += delta;
   book_set_page_no(reader->view.book, page_no);
 
   event_queue_push(reader->evqueue, Events_BOOK_UPDATED, reader->view.book);
@@ -249,6 +281,42 @@ static void reader_refresh(enum Events __, ref_t ___, void *sub_data) {
   reader_view_refresh(&reader->view);
 }
 
+static void reader_request_page(enum Events __, ref_t ___, void *sub_data) {
+  reader_t reader = sub_data;
+  reader_view_request_page(&reader->view, page_ready_cb, reader->evqueue);
+}
+
+/**
+   Content box job can finish after the reader switched to another book,
+   its result is kept by that book and applied once it is opened again.
+*/
+static void reader_crop(enum Events __, ref_t book, void *sub_data) {
+  reader_t reader = sub_data;
+
+  if (book != reader->view.book) {
+    return;
+  }
+
+  if (reader_view_auto_crop(reader->view.book, NULL, NULL)) {
+    reader_request_page(Events_NONE, NULL, reader);
+  }
+}
+
+/**
+   Called from the library worker. Event queue outlives the library, unlike
+   the reader, so it is safe to use even for a render finished during
+   shutdown.
+*/
+static void page_ready_cb(book_t book, void *data) {
+  event_queue_t evqueue = data;
+  event_queue_push(evqueue, Events_BOOK_PAGE_READY, book);
+}
+
+static void crop_ready_cb(book_t book, void *data) {
+  event_queue_t evqueue = data;
+  event_queue_push(evqueue, Events_BOOK_CROP_READY, book);
+}
+
 static void reader_put_in_bg(enum Events __, ref_t ___, void *sub_data) {
   reader_t reader = sub_data;
 
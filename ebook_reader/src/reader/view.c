@@ -8,8 +8,13 @@
 #include "utils/err.h"
 #include "utils/log.h"
 #include "utils/mem.h"
+#include "utils/settings.h"
 
 static void reader_page_event_cb(lv_event_t *e);
+static void reader_view_turn_timer_cb(lv_timer_t *timer);
+static void reader_view_turn_window_open(struct ReaderView *view);
+static void reader_view_refresh_preview(struct ReaderView *view,
+                                        struct ReaderViewBook *book_new);
 
 err_t reader_view_init(struct ReaderView *view, book_t book,
                        void (*next_page_cb)(void *),
@@ -43,6 +48,9 @@ err_t reader_view_init(struct ReaderView *view, book_t book,
                          reader_page_event_cb, view);
   ERR_TRY(err_o);
 
+  book_prefetch(book, lv_display_get_horizontal_resolution(NULL),
+                lv_display_get_vertical_resolution(NULL));
+
   return 0;
 
 error_out:
@@ -52,11 +60,16 @@ error_out:
 
 void reader_view_destroy(struct ReaderView *view) {
   puts(__func__);
+  if (view->turn_timer) {
+    lv_timer_delete(view->turn_timer);
+  }
+
   if (view->page) {
     wdgt_page_destroy(&view->page);
   }
 
   if (view->book) {
+    book_cancel_jobs(view->book);
     mem_deref(view->book);
     log_debug("Book destroyed");
   }
@@ -64,6 +77,84 @@ void reader_view_destroy(struct ReaderView *view) {
   *view = (struct ReaderView){0};
 }
 
+/**
+   Current page is shown right away if it is cached, otherwise it is
+   rendered by the library worker and `on_ready` is called once it is done.
+*/
+void reader_view_request_page(struct ReaderView *view,
+                              void (*on_ready)(book_t, void *), void *data) {
+  int x = lv_display_get_horizontal_resolution(NULL);
+  int y = lv_display_get_vertical_resolution(NULL);
+
+  if (book_is_page_cached(view->book, x, y)) {
+    book_cancel_page_jobs(view->book);
+    reader_view_refresh(view);
+    return;
+  }
+
+  book_request_page(view->book, x, y, on_ready, data);
+}
+
+/**
+   Crop margins of the book to the panel size. Called with the book which is
+   about to be shown, before the view is initialized.
+*/
+bool reader_view_auto_crop(book_t book, void (*on_ready)(book_t, void *),
+                           void *data) {
+  return book_auto_crop(book, lv_display_get_horizontal_resolution(NULL),
+                        lv_display_get_vertical_resolution(NULL), on_ready,
+                        data);
+}
+
+/**
+   Single page turn is applied right away and opens a window of
+   `settings_page_turn_window_ms`. Turns arriving within the window are
+   merged, `turn_cb` gets their net delta once the window is over. Held down
+   key then costs one render and one panel refresh per window instead of one
+   per key repeat.
+*/
+void reader_view_turn_page(struct ReaderView *view, int delta,
+                           void (*turn_cb)(int delta, void *), void *data) {
+  if (settings_page_turn_window_ms <= 0) {
+    turn_cb(delta, data);
+    return;
+  }
+
+  view->turn_cb = turn_cb;
+  view->turn_data = data;
+  if (view->turn_timer) {
+    view->turn_delta += delta;
+    return;
+  }
+
+  reader_view_turn_window_open(view);
+  turn_cb(delta, data);
+}
+
+static void reader_view_turn_window_open(struct ReaderView *view) {
+  view->turn_timer = lv_timer_create(reader_view_turn_timer_cb,
+                                     settings_page_turn_window_ms, view);
+  lv_timer_set_repeat_count(view->turn_timer, 1);
+}
+
+/**
+   Timer with a single repeat is deleted by LVGL after this call. Merged
+   turns open the next window, so turns which keep coming are merged as well.
+*/
+static void reader_view_turn_timer_cb(lv_timer_t *timer) {
+  struct ReaderView *view = lv_timer_get_user_data(timer);
+  int delta = view->turn_delta;
+
+  view->turn_timer = NULL;
+  view->turn_delta = 0;
+  if (!delta) {
+    return;
+  }
+
+  reader_view_turn_window_open(view);
+  view->turn_cb(delta, view->turn_data);
+}
+
 err_t reader_view_refresh(struct ReaderView *view) {
   struct ReaderViewBook book_new = {
       .scale = book_get_scale(view->book),
@@ -76,6 +167,15 @@ err_t reader_view_refresh(struct ReaderView *view) {
     goto out;
   };
 
+  // Page which is not cached yet is still rendered by the worker, until
+  // its render is done only its preview can be shown.
+  if (!book_is_page_cached(view->book,
+                           lv_display_get_horizontal_resolution(NULL),
+                           lv_display_get_vertical_resolution(NULL))) {
+    reader_view_refresh_preview(view, &book_new);
+    goto out;
+  }
+
   const unsigned char *page_data;
   int page_size = 0;
 
@@ -86,7 +186,11 @@ err_t reader_view_refresh(struct ReaderView *view) {
 
   wdgt_page_refresh(view->page, page_data, page_size);
 
+  book_prefetch(view->book, lv_display_get_horizontal_resolution(NULL),
+                lv_display_get_vertical_resolution(NULL));
+
   view->last_book = book_new;
+  view->last_preview = (struct ReaderViewBook){0};
 
 out:
   return 0;
@@ -96,6 +200,26 @@ error_out:
   return err_o;
 }
 
+static void reader_view_refresh_preview(struct ReaderView *view,
+                                        struct ReaderViewBook *book_new) {
+  int page_size = 0;
+
+  if (memcmp(&view->last_preview, book_new, sizeof(struct ReaderViewBook)) ==
+      0) {
+    return;
+  }
+
+  const unsigned char *page_data =
+      book_get_preview(view->book, lv_display_get_horizontal_resolution(NULL),
+                       lv_display_get_vertical_resolution(NULL), &page_size);
+  if (!page_data) {
+    return;
+  }
+
+  wdgt_page_refresh(view->page, page_data, page_size);
+  view->last_preview = *book_new;
+}
+
 static void reader_page_event_cb(lv_event_t *e) {
   struct ReaderView *view = lv_event_get_user_data(e);
   lv_key_t key = lv_event_get_key(e);
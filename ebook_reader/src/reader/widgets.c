@@ -14,7 +14,8 @@ err_t wdgt_page_init(wdgt_page_t *out, const unsigned char *page_data,
 
   lv_img_dsc_t *dsc = mem_malloc(sizeof(lv_img_dsc_t));
   *dsc = (lv_img_dsc_t){0};
-  dsc->header.cf = LV_COLOR_FORMAT_ARGB8888;
+  // Pages are 1bpp images with black and white palette.
+  dsc->header.cf = LV_COLOR_FORMAT_I1;
   dsc->header.w = lv_display_get_horizontal_resolution(NULL);
   dsc->header.h = lv_display_get_vertical_resolution(NULL);
   dsc->data_size = page_size;
@@ -0,0 +1,34 @@
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <sys/stat.h>
+
+#include "utils/err.h"
+#include "utils/fs.h"
+
+err_t fs_mkdirs(const char *dir) {
+  char path[PATH_MAX];
+
+  snprintf(path, sizeof(path), "%s", dir);
+  for (char *p = path + 1; *p; p++) {
+    if (*p != '/') {
+      continue;
+    }
+
+    *p = 0;
+    if (mkdir(path, 0755) == -1 && errno != EEXIST) {
+      goto error_out;
+    }
+    *p = '/';
+  }
+
+  if (mkdir(path, 0755) == -1 && errno != EEXIST) {
+    goto error_out;
+  }
+
+  return 0;
+
+error_out:
+  err_o = err_errnof(errno, "Cannot create directory: %s", path);
+  return err_o;
+}
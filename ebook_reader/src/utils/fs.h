@@ -0,0 +1,11 @@
+#ifndef FS_H
+#define FS_H
+
+#include "utils/err.h"
+
+/**
+   @brief Create directory together with all missing parents, like `mkdir -p`.
+*/
+err_t fs_mkdirs(const char *dir);
+
+#endif // FS_H
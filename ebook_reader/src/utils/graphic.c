@@ -2,28 +2,123 @@
 #include <stdint.h>
 #include <string.h>
 
+#include "utils/graphic.h"
+
+/**
+   Pixels brighter than the threshold are white. Transparent pixels are not
+   covered by the page and are shown as white paper.
+*/
+static inline bool graphic_is_bright(uint32_t p) {
+  uint8_t a = (p >> 24) & 0xFF;
+  uint8_t r = (p >> 16) & 0xFF;
+  uint8_t g = (p >> 8) & 0xFF;
+  uint8_t b = (p >> 0) & 0xFF;
+
+  uint16_t lum = (uint16_t)(r * 30 + g * 59 + b * 11) / 100;
+  return a < 0x80 || lum > 130;
+}
+
 void graphic_argb32_to_i1(uint8_t *dst, int w, int h, const uint8_t *src,
                           int stride) {
   int dst_stride = (w + 7) / 8;
-  memset(dst, 0x00, dst_stride * h); // 0 = white
+  memset(dst, 0x00, dst_stride * h);
+
+  graphic_argb32_blit_i1(dst, w, 0, 0, src, w, h, stride);
+}
+
+void graphic_argb32_blit_i1(uint8_t *dst, int dst_w, int dst_x, int dst_y,
+                            const uint8_t *src, int w, int h, int stride) {
+  int dst_stride = (dst_w + 7) / 8;
 
   for (int y = 0; y < h; y++) {
     const uint32_t *row = (const uint32_t *)(src + y * stride);
+    uint8_t *dst_row = dst + (dst_y + y) * dst_stride;
     for (int x = 0; x < w; x++) {
-      uint32_t p = row[x]; // 0xAARRGGBB on little-endian
-      uint8_t r = (p >> 16) & 0xFF;
-      uint8_t g = (p >> 8) & 0xFF;
-      uint8_t b = (p >> 0) & 0xFF;
+      int byte_i = (dst_x + x) >> 3;
+      int bit = 7 - ((dst_x + x) & 7); // MSB first
 
-      uint16_t lum = (uint16_t)(r * 30 + g * 59 + b * 11) / 100;
-      bool black = lum > 130;
+      if (graphic_is_bright(row[x])) {
+        dst_row[byte_i] |= (1u << bit);
+      } else {
+        dst_row[byte_i] &= ~(1u << bit);
+      }
+    }
+  }
+}
 
-      int byte_i = y * dst_stride + (x >> 3);
+void graphic_argb32_scale_to_i1(uint8_t *dst, int w, int h, const uint8_t *src,
+                                int src_w, int src_h, int stride) {
+  int dst_stride = (w + 7) / 8;
+  memset(dst, 0x00, dst_stride * h);
 
+  for (int y = 0; y < h; y++) {
+    const uint32_t *row =
+        (const uint32_t *)(src + (int64_t)y * src_h / h * stride);
+    uint8_t *dst_row = dst + y * dst_stride;
+    for (int x = 0; x < w; x++) {
       int bit = 7 - (x & 7); // MSB first
-      if (black) {
-        dst[byte_i] |= (1u << bit);
+      if (graphic_is_bright(row[(int64_t)x * src_w / w])) {
+        dst_row[x >> 3] |= (1u << bit);
+      }
+    }
+  }
+}
+
+bool graphic_argb32_content_box(const uint8_t *src, int w, int h, int stride,
+                                int box[4]) {
+  int left = w, top = h, right = 0, bottom = 0;
+
+  for (int y = 0; y < h; y++) {
+    const uint32_t *row = (const uint32_t *)(src + y * stride);
+    for (int x = 0; x < w; x++) {
+      if (graphic_is_bright(row[x])) {
+        continue;
       }
+
+      left = x < left ? x : left;
+      right = x + 1 > right ? x + 1 : right;
+      top = y < top ? y : top;
+      bottom = y + 1;
+    }
+  }
+
+  if (left >= right) {
+    return false;
+  }
+
+  box[0] = left;
+  box[1] = top;
+  box[2] = right;
+  box[3] = bottom;
+
+  return true;
+}
+
+size_t graphic_i1_image_len(int w, int h) {
+  return GRAPHIC_I1_PALETTE_LEN + (size_t)(w + 7) / 8 * h;
+}
+
+uint8_t *graphic_i1_image_init(uint8_t *image, int w, int h) {
+  // Palette entries are ARGB8888 stored as BGRA bytes.
+  const uint8_t palette[GRAPHIC_I1_PALETTE_LEN] = {
+      0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  };
+
+  memcpy(image, palette, sizeof(palette));
+  memset(image + GRAPHIC_I1_PALETTE_LEN, 0xFF, (size_t)(w + 7) / 8 * h);
+
+  return image + GRAPHIC_I1_PALETTE_LEN;
+}
+
+void graphic_i1_to_l8(uint8_t *dst, int w, int h, const uint8_t *src) {
+  int src_stride = (w + 7) / 8;
+
+  for (int y = 0; y < h; y++) {
+    uint8_t *row = dst + y * w;
+    const uint8_t *src_row = src + y * src_stride;
+    for (int x = 0; x < w; x++) {
+      int bit = 7 - (x & 7); // MSB first
+      row[x] = (src_row[x >> 3] & (1u << bit)) ? 0xFF : 0x00;
     }
   }
 }
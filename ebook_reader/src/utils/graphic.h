@@ -2,10 +2,50 @@
 #define GRAPHIC_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
+/**
+   1bpp frames are packed MSB first with stride of `(w + 7) / 8` bytes, set
+   bits are white pixels.
+*/
+#define GRAPHIC_I1_PALETTE_LEN 8
+
 void graphic_argb32_to_i1(uint8_t *dst, int w, int h, const uint8_t *src,
                           int stride);
+
+/**
+   @brief Threshold `w`x`h` ARGB32 area into 1bpp frame `dst_w` pixels wide,
+   at `dst_x`x`dst_y`.
+*/
+void graphic_argb32_blit_i1(uint8_t *dst, int dst_w, int dst_x, int dst_y,
+                            const uint8_t *src, int w, int h, int stride);
+
+/**
+   @brief Stretch ARGB32 image to 1bpp frame of `w`x`h`, nearest pixel.
+*/
+void graphic_argb32_scale_to_i1(uint8_t *dst, int w, int h, const uint8_t *src,
+                                int src_w, int src_h, int stride);
+
+/**
+   @brief Find bounding box of dark pixels, as `left`, `top`, `right` and
+   `bottom` where right and bottom are exclusive.
+   @return False if there are no dark pixels.
+*/
+bool graphic_argb32_content_box(const uint8_t *src, int w, int h, int stride,
+                                int box[4]);
+
+/**
+   @brief Size of LVGL I1 image, palette followed by the frame.
+*/
+size_t graphic_i1_image_len(int w, int h);
+
+/**
+   @brief Write black and white palette, clear the frame to white.
+   @return Frame of the image.
+*/
+uint8_t *graphic_i1_image_init(uint8_t *image, int w, int h);
+void graphic_i1_to_l8(uint8_t *dst, int w, int h, const uint8_t *src);
 void graphic_argb32_to_a1(uint8_t *dst, int w, int h, const uint8_t *src,
                           int stride);
 
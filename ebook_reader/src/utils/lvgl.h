@@ -3,6 +3,7 @@
 
 typedef struct _lv_obj_t *lvgl_obj_t;
 typedef struct _lv_event_t *lvgl_event_t;
+typedef struct _lv_timer_t *lvgl_timer_t;
 
 lvgl_obj_t lvgl_obj_create(lvgl_obj_t parent);
 lvgl_obj_t lvgl_img_create(lvgl_obj_t parent);
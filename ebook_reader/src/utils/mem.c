@@ -1,4 +1,5 @@
 #include <errno.h>
+#include <stdatomic.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -19,8 +20,9 @@ void *mem_malloc(size_t size) {
 
 void mem_free(void *mem) { free(mem); }
 
+// Counter is atomic, references are shared with worker threads.
 struct Reference {
-  int ref_count;
+  atomic_int ref_count;
   void (*destroy)(ref_t);
   uint8_t bytes[];
 };
@@ -28,7 +30,7 @@ struct Reference {
 ref_t mem_refalloc(size_t size, void (*destroy)(ref_t)) {
   struct Reference *ref;
   ref = mem_malloc(sizeof(struct Reference) + size);
-  ref->ref_count = 1;
+  atomic_init(&ref->ref_count, 1);
   ref->destroy = destroy;
 
   return ref->bytes;
@@ -40,7 +42,7 @@ ref_t mem_ref(ref_t data) {
   }
 
   struct Reference *ref = mem_container_of(data, struct Reference, bytes);
-  ref->ref_count++;
+  atomic_fetch_add(&ref->ref_count, 1);
 
   /* log_debug("Ref count: %p=%d", ref->bytes, ref->ref_count); */
 
@@ -53,7 +55,7 @@ ref_t mem_deref(ref_t data) {
   }
 
   struct Reference *ref = mem_container_of(data, struct Reference, bytes);
-  if (--ref->ref_count == 0) {
+  if (atomic_fetch_sub(&ref->ref_count, 1) == 1) {
     if (ref->destroy) {
       ref->destroy(data);
     }
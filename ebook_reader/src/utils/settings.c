@@ -11,6 +11,27 @@
 
   DISPLAY_MODEL display model used with a device instance.
   DISPLAY_BOOT_SCREEN_PATH path to image displayed during boot.
+  PAGE_CACHE_BYTES memory budget for rendered pages kept by each open book.
+  TILE_CACHE_BYTES memory budget for page tiles kept by each open book,
+   offset changes are composed out of them instead of rendering the page.
+  PREVIEW_DIVISOR pages which are not rendered yet are first shown as
+   a preview with resolution divided by this value, 1 disables previews.
+  PAGE_TURN_WINDOW_MS first page turn is shown right away, turns following
+   it within this time are merged into a single render, 0 disables merging.
+  AUTO_CROP books which were not scaled or moved by the user are opened with
+   their margins cropped, 0 disables it.
+  DOC_POOL_FILES number of parsed documents kept open, shared by all books.
+  DOC_POOL_BYTES approximate memory budget of the open documents, measured
+   by estimated size of their parsed state, mapped files are not counted.
+  THUMBNAIL_THREADS number of threads rendering thumbnails of the menu,
+   0 uses one per online CPU.
+  PREFETCH_AHEAD number of pages after the shown one rendered in background.
+  PREFETCH_BEHIND number of pages before the shown one rendered in background.
+  PAGE_STORE_DIR directory keeping rendered pages between reboots.
+  PAGE_STORE_BYTES disk budget of the page store.
+  CATALOG_PATH file keeping metadata of books between reboots.
+  LIBRARY_DEBOUNCE_MS quiet time after the last change in the books directory
+   before the library is updated.
  */
 
 #include "settings.h"
@@ -35,7 +56,82 @@
 #error "Unsupported display model"
 #endif
 
+#ifndef EBK_PAGE_CACHE_BYTES
+// Enough for about eighty 480x800 1bpp pages.
+#define EBK_PAGE_CACHE_BYTES (4 * 1024 * 1024)
+#endif
+
+#ifndef EBK_TILE_CACHE_BYTES
+// Enough for tiles of the shown page and its neighbours at any zoom.
+#define EBK_TILE_CACHE_BYTES (8 * 1024 * 1024)
+#endif
+
+#ifndef EBK_DOC_POOL_FILES
+// Reader alternating between a couple of books never parses them again.
+#define EBK_DOC_POOL_FILES 4
+#endif
+
+#ifndef EBK_DOC_POOL_BYTES
+#define EBK_DOC_POOL_BYTES (32 * 1024 * 1024)
+#endif
+
+#ifndef EBK_PREVIEW_DIVISOR
+#define EBK_PREVIEW_DIVISOR 4
+#endif
+
+#ifndef EBK_PAGE_TURN_WINDOW_MS
+// Short enough to go unnoticed next to the panel refresh.
+#define EBK_PAGE_TURN_WINDOW_MS 150
+#endif
+
+#ifndef EBK_AUTO_CROP
+#define EBK_AUTO_CROP 1
+#endif
+
+#ifndef EBK_THUMBNAIL_THREADS
+#define EBK_THUMBNAIL_THREADS 0
+#endif
+
+#ifndef EBK_PREFETCH_AHEAD
+#define EBK_PREFETCH_AHEAD 1
+#endif
+
+#ifndef EBK_PREFETCH_BEHIND
+#define EBK_PREFETCH_BEHIND 1
+#endif
+
+#ifndef EBK_PAGE_STORE_DIR
+#define EBK_PAGE_STORE_DIR "/mnt/sdcard/.ebook_reader/pages"
+#endif
+
+#ifndef EBK_PAGE_STORE_BYTES
+#define EBK_PAGE_STORE_BYTES (64 * 1024 * 1024)
+#endif
+
+#ifndef EBK_CATALOG_PATH
+#define EBK_CATALOG_PATH "/mnt/sdcard/.ebook_reader/catalog"
+#endif
+
+#ifndef EBK_LIBRARY_DEBOUNCE_MS
+// Copying a batch of books ends up as a single library update.
+#define EBK_LIBRARY_DEBOUNCE_MS 1000
+#endif
+
 const enum DisplayModelEnum settings_display_model = EBK_DISPLAY_MODEL;
 const char *settings_boot_screen_path = EBK_DISPLAY_BOOT_SCREEN_PATH;
 const char *settings_books_dir = "/mnt/sdcard";
 const char *settings_input_path = "/dev/input/event0";
+const size_t settings_page_cache_bytes = EBK_PAGE_CACHE_BYTES;
+const size_t settings_tile_cache_bytes = EBK_TILE_CACHE_BYTES;
+const int settings_doc_pool_files = EBK_DOC_POOL_FILES;
+const size_t settings_doc_pool_bytes = EBK_DOC_POOL_BYTES;
+const int settings_preview_divisor = EBK_PREVIEW_DIVISOR;
+const int settings_page_turn_window_ms = EBK_PAGE_TURN_WINDOW_MS;
+const int settings_auto_crop = EBK_AUTO_CROP;
+const int settings_thumbnail_threads = EBK_THUMBNAIL_THREADS;
+const int settings_prefetch_ahead = EBK_PREFETCH_AHEAD;
+const int settings_prefetch_behind = EBK_PREFETCH_BEHIND;
+const char *settings_page_store_dir = EBK_PAGE_STORE_DIR;
+const size_t settings_page_store_bytes = EBK_PAGE_STORE_BYTES;
+const char *settings_catalog_path = EBK_CATALOG_PATH;
+const int settings_library_debounce_ms = EBK_LIBRARY_DEBOUNCE_MS;
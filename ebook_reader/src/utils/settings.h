@@ -1,6 +1,8 @@
 #ifndef SETTINGS_H
 #define SETTINGS_H
 
+#include <stddef.h>
+
 enum DisplayModelEnum {
   DisplayModelEnum_X11 = 0,
   DisplayModelEnum_WVS7IN5V2B,
@@ -12,5 +14,19 @@ extern const enum DisplayModelEnum settings_display_model;
 extern const char *settings_boot_screen_path;
 extern const char *settings_input_path;
 extern const char *settings_books_dir;
+extern const size_t settings_page_cache_bytes;
+extern const size_t settings_tile_cache_bytes;
+extern const int settings_doc_pool_files;
+extern const size_t settings_doc_pool_bytes;
+extern const int settings_preview_divisor;
+extern const int settings_page_turn_window_ms;
+extern const int settings_auto_crop;
+extern const int settings_thumbnail_threads;
+extern const int settings_prefetch_ahead;
+extern const int settings_prefetch_behind;
+extern const char *settings_page_store_dir;
+extern const size_t settings_page_store_bytes;
+extern const char *settings_catalog_path;
+extern const int settings_library_debounce_ms;
 
 #endif // SETTINGS_H
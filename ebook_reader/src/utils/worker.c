@@ -0,0 +1,196 @@
+#include <stdbool.h>
+#include <threads.h>
+
+#include "utils/err.h"
+#include "utils/mem.h"
+#include "utils/worker.h"
+
+typedef struct WorkerJob *worker_job_t;
+
+struct WorkerJob {
+  void *owner;
+  worker_job_func_t func;
+  ref_t data;
+  worker_job_t next;
+};
+
+struct Worker {
+  thrd_t *threads;
+  int threads_len;
+  mtx_t lock;
+  cnd_t job_ready;
+  worker_job_t head;
+  worker_job_t tail;
+  bool is_stopping;
+};
+
+static int worker_main(void *arg);
+static worker_job_t worker_pull(worker_t worker);
+static void worker_join(worker_t worker);
+
+err_t worker_init(worker_t *out, int threads) {
+  worker_t worker = *out = mem_malloc(sizeof(struct Worker));
+  *worker = (struct Worker){
+      .threads = mem_malloc(sizeof(thrd_t) * (threads > 0 ? threads : 1)),
+  };
+
+  if (mtx_init(&worker->lock, mtx_plain) != thrd_success) {
+    err_o = err_errnos(ENOMEM, "Cannot create worker lock");
+    goto error_out;
+  }
+
+  if (cnd_init(&worker->job_ready) != thrd_success) {
+    err_o = err_errnos(ENOMEM, "Cannot create worker condition");
+    goto error_lock_cleanup;
+  }
+
+  for (; worker->threads_len < (threads > 0 ? threads : 1);
+       worker->threads_len++) {
+    if (thrd_create(&worker->threads[worker->threads_len], worker_main,
+                    worker) != thrd_success) {
+      err_o = err_errnos(EAGAIN, "Cannot create worker thread");
+      goto error_threads_cleanup;
+    }
+  }
+
+  return 0;
+
+error_threads_cleanup:
+  worker_join(worker);
+  cnd_destroy(&worker->job_ready);
+error_lock_cleanup:
+  mtx_destroy(&worker->lock);
+error_out:
+  mem_free(worker->threads);
+  mem_free(worker);
+  *out = NULL;
+  return err_o;
+}
+
+void worker_destroy(worker_t *out) {
+  if (mem_is_null_ptr(out)) {
+    return;
+  }
+
+  worker_t worker = *out;
+  worker_join(worker);
+
+  worker_job_t job;
+  while ((job = worker_pull(worker)) != NULL) {
+    mem_deref(job->data);
+    mem_free(job);
+  }
+
+  cnd_destroy(&worker->job_ready);
+  mtx_destroy(&worker->lock);
+  mem_free(worker->threads);
+  mem_free(worker);
+  *out = NULL;
+}
+
+void worker_submit(worker_t worker, void *owner, worker_job_func_t func,
+                   ref_t data) {
+  worker_job_t job = mem_malloc(sizeof(struct WorkerJob));
+  *job = (struct WorkerJob){
+      .owner = owner,
+      .func = func,
+      .data = mem_ref(data),
+  };
+
+  mtx_lock(&worker->lock);
+  if (worker->tail) {
+    worker->tail->next = job;
+  } else {
+    worker->head = job;
+  }
+  worker->tail = job;
+  cnd_signal(&worker->job_ready);
+  mtx_unlock(&worker->lock);
+}
+
+void worker_cancel(worker_t worker, void *owner) {
+  worker_job_t cancelled = NULL;
+
+  mtx_lock(&worker->lock);
+  worker_job_t *p = &worker->head;
+  worker->tail = NULL;
+  while (*p) {
+    worker_job_t job = *p;
+    if (job->owner != owner) {
+      worker->tail = job;
+      p = &job->next;
+      continue;
+    }
+
+    *p = job->next;
+    job->next = cancelled;
+    cancelled = job;
+  }
+  mtx_unlock(&worker->lock);
+
+  // Data is released outside of the lock, its destructor may be heavy.
+  while (cancelled) {
+    worker_job_t job = cancelled;
+    cancelled = job->next;
+    mem_deref(job->data);
+    mem_free(job);
+  }
+}
+
+static int worker_main(void *arg) {
+  worker_t worker = arg;
+  worker_job_t job;
+
+  mtx_lock(&worker->lock);
+  while (!worker->is_stopping) {
+    job = worker_pull(worker);
+    if (!job) {
+      cnd_wait(&worker->job_ready, &worker->lock);
+      continue;
+    }
+
+    mtx_unlock(&worker->lock);
+
+    job->func(job->data);
+    mem_deref(job->data);
+    mem_free(job);
+
+    mtx_lock(&worker->lock);
+  }
+  mtx_unlock(&worker->lock);
+
+  return 0;
+}
+
+/**
+   Stop all threads of the worker, jobs which are still pending are left in
+   the queue.
+*/
+static void worker_join(worker_t worker) {
+  mtx_lock(&worker->lock);
+  worker->is_stopping = true;
+  cnd_broadcast(&worker->job_ready);
+  mtx_unlock(&worker->lock);
+
+  for (int i = 0; i < worker->threads_len; i++) {
+    thrd_join(worker->threads[i], NULL);
+  }
+}
+
+/**
+   Caller has to hold the lock, or be the only user of the worker.
+*/
+static worker_job_t worker_pull(worker_t worker) {
+  worker_job_t job = worker->head;
+  if (!job) {
+    return NULL;
+  }
+
+  worker->head = job->next;
+  if (!worker->head) {
+    worker->tail = NULL;
+  }
+
+  job->next = NULL;
+  return job;
+}
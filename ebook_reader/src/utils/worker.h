@@ -0,0 +1,32 @@
+#ifndef WORKER_H
+#define WORKER_H
+
+#include "utils/err.h"
+#include "utils/mem.h"
+
+/**
+   Worker runs jobs on a pool of background threads, taken in submission
+   order. Worker with a single thread runs them one by one, so each job
+   starts only after the previous one is done.
+
+   Every job is tagged with an owner, so all pending jobs of e.g. one book
+   can be dropped at once. Job data is a reference, worker keeps its own
+   reference until the job is done or cancelled.
+*/
+
+typedef struct Worker *worker_t;
+typedef void (*worker_job_func_t)(ref_t data);
+
+err_t worker_init(worker_t *out, int threads);
+void worker_destroy(worker_t *out);
+void worker_submit(worker_t worker, void *owner, worker_job_func_t func,
+                   ref_t data);
+
+/**
+   @brief Drop all pending jobs of the owner.
+   @note Job which is already running is not interrupted, cancel never blocks
+   the caller for the time of a job.
+*/
+void worker_cancel(worker_t worker, void *owner);
+
+#endif // WORKER_H
@@ -18,6 +18,40 @@ int zlist_append(zlist_t head, zlist_node_t node) {
   return 0;
 }
 
+int zlist_prepend(zlist_t head, zlist_node_t node) {
+  if (!head || !node) {
+    err_o = err_errnos(EINVAL, "`head` and `node` cannot be NULL");
+    return -1;
+  }
+
+  head->len++;
+  node->next = head->head;
+  head->head = node;
+  return 0;
+}
+
+int zlist_insert(zlist_t head, int idx, zlist_node_t node) {
+  if (!head || !node) {
+    err_o = err_errnos(EINVAL, "`head` and `node` cannot be NULL");
+    return -1;
+  }
+
+  if (idx < 0 || (uint32_t)idx > head->len) {
+    err_o = err_errnof(EINVAL, "Index %d out of list of %u", idx, head->len);
+    return -1;
+  }
+
+  zlist_node_t *p = &head->head;
+  while (idx--) {
+    p = &(*p)->next;
+  }
+
+  head->len++;
+  node->next = *p;
+  *p = node;
+  return 0;
+}
+
 zlist_node_t zlist_get(zlist_t list, int idx) {
   int i = 0;
   for (zlist_node_t node = list->head; node != NULL; node = node->next) {
@@ -33,6 +33,23 @@ struct ZListNode {
 */
 int zlist_append(zlist_t head, zlist_node_t node);
 
+/**
+   @brief Prepend node to zero list, unlike append it does not walk the list.
+   @param head Head of the zero list.
+   @param node Node that will be prepended.
+   @return On success 0, on error return -1 and set ebk_errno.
+*/
+int zlist_prepend(zlist_t head, zlist_node_t node);
+
+/**
+   @brief Insert node to zero list, so it ends up at the given index.
+   @param head Head of the zero list.
+   @param idx Index of inserted node, at most length of the list.
+   @param node Node that will be inserted.
+   @return On success 0, on error return -1 and set ebk_errno.
+*/
+int zlist_insert(zlist_t head, int idx, zlist_node_t node);
+
 /**
    @brief Get node from zero list.
    @param head Head of the zero list.
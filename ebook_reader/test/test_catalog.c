@@ -0,0 +1,166 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <unity.h>
+
+#include "library/catalog.h"
+#include "utils/err.h"
+
+static char path[] = "/tmp/test_catalog_XXXXXX";
+static catalog_t catalog;
+
+static struct CatalogEntry mk_entry(char *file_name, char *title) {
+  return (struct CatalogEntry){
+      .file_name = file_name,
+      .size = 1024,
+      .mtime = 1700000000,
+      .title = title,
+      .pages = 42,
+  };
+}
+
+void setUp(void) {
+  err_o = (err_t){0};
+  strcpy(path, "/tmp/test_catalog_XXXXXX");
+  int fd = mkstemp(path);
+  TEST_ASSERT_TRUE(fd != -1);
+  close(fd);
+  remove(path);
+  TEST_ASSERT_NULL(catalog_init(&catalog, path));
+}
+
+void tearDown(void) {
+  catalog_destroy(&catalog);
+  remove(path);
+}
+
+void test_catalog_find_returns_put_entry(void) {
+  struct CatalogEntry entry = mk_entry("a.pdf", "A");
+
+  catalog_begin_scan(catalog);
+  TEST_ASSERT_NULL(catalog_find(catalog, "a.pdf", 1024, 1700000000));
+  catalog_put(catalog, &entry);
+
+  const struct CatalogEntry *found =
+      catalog_find(catalog, "a.pdf", 1024, 1700000000);
+  TEST_ASSERT_NOT_NULL(found);
+  TEST_ASSERT_EQUAL(0, strcmp("A", found->title));
+  TEST_ASSERT_EQUAL(42, found->pages);
+}
+
+void test_catalog_find_ignores_changed_file(void) {
+  struct CatalogEntry entry = mk_entry("a.pdf", "A");
+
+  catalog_put(catalog, &entry);
+
+  TEST_ASSERT_NULL(catalog_find(catalog, "a.pdf", 2048, 1700000000));
+  TEST_ASSERT_NULL(catalog_find(catalog, "a.pdf", 1024, 1700000001));
+}
+
+void test_catalog_survives_reinit(void) {
+  struct CatalogEntry entry = mk_entry("a.pdf", "A");
+
+  catalog_begin_scan(catalog);
+  catalog_put(catalog, &entry);
+  TEST_ASSERT_NULL(catalog_save(catalog));
+  catalog_destroy(&catalog);
+
+  TEST_ASSERT_NULL(catalog_init(&catalog, path));
+  const struct CatalogEntry *found =
+      catalog_find(catalog, "a.pdf", 1024, 1700000000);
+  TEST_ASSERT_NOT_NULL(found);
+  TEST_ASSERT_EQUAL(0, strcmp("A", found->title));
+  TEST_ASSERT_EQUAL(42, found->pages);
+}
+
+void test_catalog_save_drops_entries_not_seen_by_scan(void) {
+  struct CatalogEntry entries[] = {mk_entry("a.pdf", "A"),
+                                   mk_entry("b.pdf", "B")};
+
+  catalog_begin_scan(catalog);
+  catalog_put(catalog, &entries[0]);
+  catalog_put(catalog, &entries[1]);
+  TEST_ASSERT_NULL(catalog_save(catalog));
+
+  // Lookup alone does not keep an entry.
+  catalog_begin_scan(catalog);
+  catalog_mark_seen(catalog, "b.pdf", 1024, 1700000000);
+  TEST_ASSERT_NOT_NULL(catalog_find(catalog, "a.pdf", 1024, 1700000000));
+  TEST_ASSERT_NULL(catalog_save(catalog));
+
+  TEST_ASSERT_NULL(catalog_find(catalog, "a.pdf", 1024, 1700000000));
+  TEST_ASSERT_NOT_NULL(catalog_find(catalog, "b.pdf", 1024, 1700000000));
+}
+
+void test_catalog_ignores_invalid_file(void) {
+  catalog_destroy(&catalog);
+
+  FILE *file = fopen(path, "wb");
+  fputs("garbage", file);
+  fclose(file);
+
+  TEST_ASSERT_NULL(catalog_init(&catalog, path));
+  TEST_ASSERT_NULL(catalog_find(catalog, "a.pdf", 1024, 1700000000));
+}
+
+void test_catalog_remove_drops_entry(void) {
+  struct CatalogEntry entries[] = {mk_entry("a.pdf", "A"),
+                                   mk_entry("b.pdf", "B")};
+
+  catalog_begin_scan(catalog);
+  catalog_put(catalog, &entries[0]);
+  catalog_put(catalog, &entries[1]);
+  TEST_ASSERT_NULL(catalog_save(catalog));
+
+  catalog_remove(catalog, "a.pdf");
+  catalog_remove(catalog, "c.pdf");
+  TEST_ASSERT_NULL(catalog_save(catalog));
+  catalog_destroy(&catalog);
+
+  TEST_ASSERT_NULL(catalog_init(&catalog, path));
+  TEST_ASSERT_NULL(catalog_find(catalog, "a.pdf", 1024, 1700000000));
+  TEST_ASSERT_NOT_NULL(catalog_find(catalog, "b.pdf", 1024, 1700000000));
+}
+
+void test_catalog_content_box_survives_reinit(void) {
+  struct CatalogEntry entry = mk_entry("a.pdf", "A");
+  struct ContentBox box = {
+      .left = 0.1, .top = 0.2, .right = 0.9, .bottom = 0.8};
+
+  catalog_begin_scan(catalog);
+  catalog_put(catalog, &entry);
+  catalog_set_content_box(catalog, "a.pdf", &box);
+  TEST_ASSERT_NULL(catalog_save(catalog));
+  catalog_destroy(&catalog);
+
+  TEST_ASSERT_NULL(catalog_init(&catalog, path));
+  const struct CatalogEntry *found =
+      catalog_find(catalog, "a.pdf", 1024, 1700000000);
+  TEST_ASSERT_NOT_NULL(found);
+  TEST_ASSERT_TRUE(found->has_content_box);
+  TEST_ASSERT_EQUAL_MEMORY(&box, &found->content_box, sizeof(box));
+}
+
+void test_catalog_finds_entries_put_in_any_order(void) {
+  char names[][8] = {"d.pdf", "b.pdf", "e.pdf", "a.pdf", "c.pdf"};
+
+  catalog_begin_scan(catalog);
+  for (int i = 0; i < 5; i++) {
+    struct CatalogEntry entry = mk_entry(names[i], names[i]);
+    catalog_put(catalog, &entry);
+  }
+  catalog_remove(catalog, "c.pdf");
+
+  TEST_ASSERT_NULL(catalog_find(catalog, "c.pdf", 1024, 1700000000));
+  for (int i = 0; i < 5; i++) {
+    if (strcmp(names[i], "c.pdf") == 0) {
+      continue;
+    }
+    const struct CatalogEntry *found =
+        catalog_find(catalog, names[i], 1024, 1700000000);
+    TEST_ASSERT_NOT_NULL(found);
+    TEST_ASSERT_EQUAL(0, strcmp(names[i], found->title));
+  }
+}
@@ -0,0 +1,110 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <unity.h>
+
+#include "library/doc_pool.h"
+#include "utils/err.h"
+#include "utils/mem.h"
+
+static doc_pool_t pool;
+static int destroyed;
+
+static void doc_destroy(ref_t doc) {
+  (void)doc;
+  destroyed++;
+}
+
+static void *doc_ref(void *doc) { return mem_ref(doc); }
+
+static void doc_unref(void *doc) { mem_deref(doc); }
+
+static void *mk_doc(void) { return mem_refalloc(sizeof(int), doc_destroy); }
+
+void setUp(void) {
+  err_o = (err_t){0};
+  destroyed = 0;
+  TEST_ASSERT_NULL(doc_pool_init(&pool, 2, 300, doc_ref, doc_unref));
+}
+
+void tearDown(void) { doc_pool_destroy(&pool); }
+
+void test_doc_pool_get_returns_referenced_doc_and_counts_hit(void) {
+  struct DocPoolStats stats;
+  void *doc = mk_doc();
+
+  TEST_ASSERT_NULL(doc_pool_get(pool, 1));
+  doc_pool_put(pool, 1, doc, 100);
+  mem_deref(doc);
+
+  void *got = doc_pool_get(pool, 1);
+  TEST_ASSERT_EQUAL_PTR(doc, got);
+  mem_deref(got);
+  TEST_ASSERT_EQUAL_INT(0, destroyed);
+
+  doc_pool_get_stats(pool, &stats);
+  TEST_ASSERT_EQUAL_UINT32(1, stats.hits);
+  TEST_ASSERT_EQUAL_UINT32(1, stats.misses);
+  TEST_ASSERT_EQUAL_UINT32(1, stats.entries);
+}
+
+void test_doc_pool_evicts_least_recently_used_over_doc_limit(void) {
+  struct DocPoolStats stats;
+
+  for (uint64_t id = 1; id <= 2; id++) {
+    void *doc = mk_doc();
+    doc_pool_put(pool, id, doc, 10);
+    mem_deref(doc);
+  }
+
+  // Touching the first document leaves the second one to evict.
+  mem_deref(doc_pool_get(pool, 1));
+
+  void *doc = mk_doc();
+  doc_pool_put(pool, 3, doc, 10);
+  mem_deref(doc);
+
+  TEST_ASSERT_EQUAL_INT(1, destroyed);
+  TEST_ASSERT_NULL(doc_pool_get(pool, 2));
+  void *got = doc_pool_get(pool, 1);
+  TEST_ASSERT_NOT_NULL(got);
+  mem_deref(got);
+
+  doc_pool_get_stats(pool, &stats);
+  TEST_ASSERT_EQUAL_UINT32(1, stats.evictions);
+  TEST_ASSERT_EQUAL_UINT32(2, stats.entries);
+}
+
+void test_doc_pool_evicts_over_budget_but_keeps_new_doc(void) {
+  struct DocPoolStats stats;
+  void *doc = mk_doc();
+  doc_pool_put(pool, 1, doc, 200);
+  mem_deref(doc);
+
+  doc = mk_doc();
+  doc_pool_put(pool, 2, doc, 400);
+  mem_deref(doc);
+
+  TEST_ASSERT_EQUAL_INT(1, destroyed);
+  void *got = doc_pool_get(pool, 2);
+  TEST_ASSERT_EQUAL_PTR(doc, got);
+  mem_deref(got);
+
+  doc_pool_get_stats(pool, &stats);
+  TEST_ASSERT_EQUAL_UINT32(1, stats.entries);
+  TEST_ASSERT_EQUAL(400, stats.bytes);
+}
+
+void test_doc_pool_evicted_doc_stays_valid_for_borrower(void) {
+  void *doc = mk_doc();
+  doc_pool_put(pool, 1, doc, 300);
+  mem_deref(doc);
+
+  void *borrowed = doc_pool_get(pool, 1);
+  doc = mk_doc();
+  doc_pool_put(pool, 2, doc, 300);
+  mem_deref(doc);
+
+  TEST_ASSERT_EQUAL_INT(0, destroyed);
+  mem_deref(borrowed);
+  TEST_ASSERT_EQUAL_INT(1, destroyed);
+}
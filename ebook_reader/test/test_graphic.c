@@ -0,0 +1,99 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <unity.h>
+
+#include "utils/graphic.h"
+
+#define WHITE 0xFFFFFFFF
+#define BLACK 0xFF000000
+
+static bool is_white(const uint8_t *frame, int w, int x, int y) {
+  return frame[y * ((w + 7) / 8) + x / 8] & (1u << (7 - x % 8));
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_graphic_i1_image_init_clears_to_white(void) {
+  uint8_t image[GRAPHIC_I1_PALETTE_LEN + 2 * 3];
+
+  TEST_ASSERT_EQUAL(sizeof(image), graphic_i1_image_len(10, 3));
+
+  uint8_t *frame = graphic_i1_image_init(image, 10, 3);
+
+  TEST_ASSERT_EQUAL_PTR(image + GRAPHIC_I1_PALETTE_LEN, frame);
+  for (int y = 0; y < 3; y++) {
+    for (int x = 0; x < 10; x++) {
+      TEST_ASSERT_TRUE(is_white(frame, 10, x, y));
+    }
+  }
+}
+
+void test_graphic_argb32_blit_i1_writes_only_area(void) {
+  uint32_t src[2 * 2] = {BLACK, WHITE, WHITE, BLACK};
+  uint8_t frame[2 * 4];
+
+  memset(frame, 0xFF, sizeof(frame));
+  graphic_argb32_blit_i1(frame, 12, 7, 1, (const uint8_t *)src, 2, 2,
+                         2 * sizeof(uint32_t));
+
+  TEST_ASSERT_FALSE(is_white(frame, 12, 7, 1));
+  TEST_ASSERT_TRUE(is_white(frame, 12, 8, 1));
+  TEST_ASSERT_TRUE(is_white(frame, 12, 7, 2));
+  TEST_ASSERT_FALSE(is_white(frame, 12, 8, 2));
+  TEST_ASSERT_TRUE(is_white(frame, 12, 6, 1));
+  TEST_ASSERT_TRUE(is_white(frame, 12, 9, 2));
+  TEST_ASSERT_EQUAL_HEX8(0xFF, frame[0]);
+  TEST_ASSERT_EQUAL_HEX8(0xFF, frame[6]);
+}
+
+void test_graphic_transparent_pixels_are_white(void) {
+  uint32_t src[2] = {0x00000000, BLACK};
+  uint8_t frame[1];
+
+  graphic_argb32_to_i1(frame, 2, 1, (const uint8_t *)src, sizeof(src));
+
+  TEST_ASSERT_TRUE(is_white(frame, 2, 0, 0));
+  TEST_ASSERT_FALSE(is_white(frame, 2, 1, 0));
+}
+
+void test_graphic_argb32_scale_to_i1_stretches_pixels(void) {
+  uint32_t src[2 * 1] = {BLACK, WHITE};
+  uint8_t frame[1 * 2];
+
+  graphic_argb32_scale_to_i1(frame, 4, 2, (const uint8_t *)src, 2, 1,
+                             sizeof(src));
+
+  for (int y = 0; y < 2; y++) {
+    TEST_ASSERT_FALSE(is_white(frame, 4, 0, y));
+    TEST_ASSERT_FALSE(is_white(frame, 4, 1, y));
+    TEST_ASSERT_TRUE(is_white(frame, 4, 2, y));
+    TEST_ASSERT_TRUE(is_white(frame, 4, 3, y));
+  }
+}
+
+void test_graphic_argb32_content_box_finds_dark_pixels(void) {
+  uint32_t src[4 * 3] = {
+      WHITE, WHITE, WHITE, WHITE, //
+      WHITE, BLACK, WHITE, WHITE, //
+      WHITE, WHITE, BLACK, WHITE, //
+  };
+  int box[4];
+
+  TEST_ASSERT_TRUE(graphic_argb32_content_box((const uint8_t *)src, 4, 3,
+                                              4 * sizeof(uint32_t), box));
+  TEST_ASSERT_EQUAL(1, box[0]);
+  TEST_ASSERT_EQUAL(1, box[1]);
+  TEST_ASSERT_EQUAL(3, box[2]);
+  TEST_ASSERT_EQUAL(3, box[3]);
+}
+
+void test_graphic_argb32_content_box_of_blank_page(void) {
+  uint32_t src[2 * 2] = {WHITE, WHITE, WHITE, WHITE};
+  int box[4];
+
+  TEST_ASSERT_FALSE(graphic_argb32_content_box((const uint8_t *)src, 2, 2,
+                                               2 * sizeof(uint32_t), box));
+}
@@ -116,6 +116,57 @@ void test_zlist_append_overwrites_node_next_to_null(void) {
   mem_free(junk);
 }
 
+void test_zlist_prepend_null_node_sets_error_and_returns_minus1(void) {
+  TEST_ASSERT_EQUAL(-1, zlist_prepend(list, NULL));
+  TEST_ASSERT_EQUAL(EINVAL, err_o->code);
+  TEST_ASSERT_NULL(list->head);
+  TEST_ASSERT_EQUAL(0, list->len);
+}
+
+void test_zlist_prepend_inserts_at_head_and_increments_len(void) {
+  zlist_node_t a = mk_node();
+  zlist_node_t b = mk_node();
+
+  TEST_ASSERT_EQUAL(0, zlist_prepend(list, b));
+  TEST_ASSERT_EQUAL(0, zlist_prepend(list, a));
+
+  TEST_ASSERT_EQUAL_PTR(a, list->head);
+  TEST_ASSERT_EQUAL_PTR(b, list->head->next);
+  TEST_ASSERT_NULL(b->next);
+
+  TEST_ASSERT_EQUAL(2, list->len);
+  TEST_ASSERT_EQUAL(2, count_nodes(list));
+}
+
+void test_zlist_insert_puts_node_at_index(void) {
+  zlist_node_t a = mk_node();
+  zlist_node_t b = mk_node();
+  zlist_node_t c = mk_node();
+
+  TEST_ASSERT_EQUAL(0, zlist_insert(list, 0, c));
+  TEST_ASSERT_EQUAL(0, zlist_insert(list, 0, a));
+  TEST_ASSERT_EQUAL(0, zlist_insert(list, 1, b));
+
+  TEST_ASSERT_EQUAL_PTR(a, zlist_get(list, 0));
+  TEST_ASSERT_EQUAL_PTR(b, zlist_get(list, 1));
+  TEST_ASSERT_EQUAL_PTR(c, zlist_get(list, 2));
+  TEST_ASSERT_NULL(c->next);
+
+  TEST_ASSERT_EQUAL(3, list->len);
+  TEST_ASSERT_EQUAL(3, count_nodes(list));
+}
+
+void test_zlist_insert_past_end_sets_error_and_returns_minus1(void) {
+  zlist_node_t a = mk_node();
+  zlist_node_t b = mk_node();
+  zlist_append(list, a);
+
+  TEST_ASSERT_EQUAL(-1, zlist_insert(list, 2, b));
+  TEST_ASSERT_EQUAL(EINVAL, err_o->code);
+  TEST_ASSERT_EQUAL(1, list->len);
+  mem_free(b);
+}
+
 void test_zlist_get_empty_returns_null(void) {
   TEST_ASSERT_NULL(list->head);
   TEST_ASSERT_NULL(zlist_get(list, 0));
@@ -0,0 +1,113 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <unity.h>
+
+#include "library/page_cache.h"
+#include "utils/err.h"
+
+static page_cache_t cache;
+static int destroyed;
+
+static void value_destroy(void *value) {
+  (void)value;
+  destroyed++;
+}
+
+static struct PageCacheKey mk_key(int page_number) {
+  return (struct PageCacheKey){
+      .page_number = page_number,
+      .scale = 1,
+      .x = 480,
+      .y = 800,
+  };
+}
+
+void setUp(void) {
+  err_o = (err_t){0};
+  destroyed = 0;
+  TEST_ASSERT_NULL(page_cache_init(&cache, 300, value_destroy));
+}
+
+void tearDown(void) { page_cache_destroy(&cache); }
+
+void test_page_cache_get_returns_put_value_and_counts_hit(void) {
+  int value;
+  struct PageCacheKey key = mk_key(1);
+  struct PageCacheStats stats;
+
+  TEST_ASSERT_NULL(page_cache_get(cache, &key));
+  page_cache_put(cache, &key, &value, 100);
+  TEST_ASSERT_EQUAL_PTR(&value, page_cache_get(cache, &key));
+
+  page_cache_get_stats(cache, &stats);
+  TEST_ASSERT_EQUAL(1, stats.hits);
+  TEST_ASSERT_EQUAL(1, stats.misses);
+  TEST_ASSERT_EQUAL(0, stats.evictions);
+  TEST_ASSERT_EQUAL(1, stats.entries);
+  TEST_ASSERT_EQUAL(100, stats.bytes);
+}
+
+void test_page_cache_key_includes_render_parameters(void) {
+  int value;
+  struct PageCacheKey key = mk_key(1);
+
+  page_cache_put(cache, &key, &value, 100);
+
+  key.scale = 1.25;
+  TEST_ASSERT_NULL(page_cache_get(cache, &key));
+  key = mk_key(1);
+  key.x_off = 25;
+  TEST_ASSERT_NULL(page_cache_get(cache, &key));
+  key = mk_key(1);
+  key.y = 400;
+  TEST_ASSERT_NULL(page_cache_get(cache, &key));
+}
+
+void test_page_cache_evicts_least_recently_used(void) {
+  int values[4];
+  struct PageCacheKey keys[4];
+  struct PageCacheStats stats;
+
+  for (int i = 0; i < 3; i++) {
+    keys[i] = mk_key(i + 1);
+    page_cache_put(cache, &keys[i], &values[i], 100);
+  }
+
+  // Touch first page, so the second one becomes the oldest.
+  TEST_ASSERT_EQUAL_PTR(&values[0], page_cache_get(cache, &keys[0]));
+
+  keys[3] = mk_key(4);
+  page_cache_put(cache, &keys[3], &values[3], 100);
+
+  TEST_ASSERT_NULL(page_cache_get(cache, &keys[1]));
+  TEST_ASSERT_EQUAL_PTR(&values[0], page_cache_get(cache, &keys[0]));
+  TEST_ASSERT_EQUAL_PTR(&values[2], page_cache_get(cache, &keys[2]));
+  TEST_ASSERT_EQUAL_PTR(&values[3], page_cache_get(cache, &keys[3]));
+
+  page_cache_get_stats(cache, &stats);
+  TEST_ASSERT_EQUAL(1, stats.evictions);
+  TEST_ASSERT_EQUAL(1, destroyed);
+  TEST_ASSERT_EQUAL(300, stats.bytes);
+}
+
+void test_page_cache_put_over_budget_releases_value(void) {
+  int value;
+  struct PageCacheKey key = mk_key(1);
+
+  page_cache_put(cache, &key, &value, 301);
+
+  TEST_ASSERT_EQUAL(1, destroyed);
+  TEST_ASSERT_NULL(page_cache_get(cache, &key));
+}
+
+void test_page_cache_destroy_releases_all_values(void) {
+  int values[2];
+  struct PageCacheKey keys[2] = {mk_key(1), mk_key(2)};
+
+  page_cache_put(cache, &keys[0], &values[0], 100);
+  page_cache_put(cache, &keys[1], &values[1], 100);
+  page_cache_destroy(&cache);
+
+  TEST_ASSERT_NULL(cache);
+  TEST_ASSERT_EQUAL(2, destroyed);
+}
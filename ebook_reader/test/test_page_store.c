@@ -0,0 +1,127 @@
+#include <dirent.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <unity.h>
+
+#include "library/page_store.h"
+#include "utils/err.h"
+
+#define FRAME_LEN (60 * 800)
+
+static char dir[] = "/tmp/test_page_store_XXXXXX";
+static page_store_t store;
+static uint8_t frame[FRAME_LEN];
+static uint8_t loaded[FRAME_LEN];
+
+static struct PageCacheKey mk_key(int page_number) {
+  return (struct PageCacheKey){
+      .page_number = page_number,
+      .scale = 1,
+      .x = 480,
+      .y = 800,
+  };
+}
+
+static int count_pages(void) {
+  struct dirent *dirent;
+  int pages = 0;
+
+  DIR *d = opendir(dir);
+  while ((dirent = readdir(d)) != NULL) {
+    if (strstr(dirent->d_name, ".i1")) {
+      pages++;
+    }
+  }
+  closedir(d);
+
+  return pages;
+}
+
+void setUp(void) {
+  err_o = (err_t){0};
+  strcpy(dir, "/tmp/test_page_store_XXXXXX");
+  TEST_ASSERT_NOT_NULL(mkdtemp(dir));
+  memset(frame, 0xA5, sizeof(frame));
+  memset(loaded, 0, sizeof(loaded));
+}
+
+void tearDown(void) {
+  char cmd[64];
+
+  page_store_destroy(&store);
+  snprintf(cmd, sizeof(cmd), "rm -rf %s", dir);
+  TEST_ASSERT_EQUAL(0, system(cmd));
+}
+
+void test_page_store_load_returns_saved_frame(void) {
+  struct PageCacheKey key = mk_key(1);
+
+  TEST_ASSERT_NULL(page_store_init(&store, dir, 1024 * 1024));
+  TEST_ASSERT_FALSE(page_store_load(store, 1, &key, loaded, FRAME_LEN));
+
+  page_store_save(store, 1, &key, frame, FRAME_LEN);
+
+  TEST_ASSERT_TRUE(page_store_load(store, 1, &key, loaded, FRAME_LEN));
+  TEST_ASSERT_EQUAL_MEMORY(frame, loaded, FRAME_LEN);
+}
+
+void test_page_store_has_saved_frame(void) {
+  struct PageCacheKey key = mk_key(1);
+
+  TEST_ASSERT_NULL(page_store_init(&store, dir, 1024 * 1024));
+  TEST_ASSERT_FALSE(page_store_has(store, 1, &key));
+
+  page_store_save(store, 1, &key, frame, FRAME_LEN);
+
+  TEST_ASSERT_TRUE(page_store_has(store, 1, &key));
+  TEST_ASSERT_FALSE(page_store_has(store, 2, &key));
+  TEST_ASSERT_FALSE(page_store_has(NULL, 1, &key));
+}
+
+void test_page_store_key_includes_file_and_render_parameters(void) {
+  struct PageCacheKey key = mk_key(1);
+
+  TEST_ASSERT_NULL(page_store_init(&store, dir, 1024 * 1024));
+  page_store_save(store, 1, &key, frame, FRAME_LEN);
+
+  TEST_ASSERT_FALSE(page_store_load(store, 2, &key, loaded, FRAME_LEN));
+  key.scale = 1.25;
+  TEST_ASSERT_FALSE(page_store_load(store, 1, &key, loaded, FRAME_LEN));
+}
+
+void test_page_store_survives_reinit(void) {
+  struct PageCacheKey key = mk_key(1);
+
+  TEST_ASSERT_NULL(page_store_init(&store, dir, 1024 * 1024));
+  page_store_save(store, 1, &key, frame, FRAME_LEN);
+  page_store_destroy(&store);
+
+  TEST_ASSERT_NULL(page_store_init(&store, dir, 1024 * 1024));
+  TEST_ASSERT_TRUE(page_store_load(store, 1, &key, loaded, FRAME_LEN));
+}
+
+void test_page_store_prunes_over_budget(void) {
+  // Budget fits four frames, fifth one triggers pruning.
+  TEST_ASSERT_NULL(page_store_init(&store, dir, FRAME_LEN * 4 + 1024));
+
+  for (int i = 1; i <= 5; i++) {
+    struct PageCacheKey key = mk_key(i);
+    page_store_save(store, 1, &key, frame, FRAME_LEN);
+  }
+
+  TEST_ASSERT_TRUE(count_pages() < 5);
+
+  struct PageCacheKey key = mk_key(5);
+  TEST_ASSERT_TRUE(page_store_load(store, 1, &key, loaded, FRAME_LEN));
+}
+
+void test_page_store_null_store_is_empty(void) {
+  struct PageCacheKey key = mk_key(1);
+
+  page_store_save(NULL, 1, &key, frame, FRAME_LEN);
+  TEST_ASSERT_FALSE(page_store_load(NULL, 1, &key, loaded, FRAME_LEN));
+}
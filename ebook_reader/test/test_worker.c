@@ -0,0 +1,100 @@
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <unity.h>
+
+#include "utils/err.h"
+#include "utils/mem.h"
+#include "utils/time.h"
+#include "utils/worker.h"
+
+static worker_t worker;
+static atomic_int executed;
+static atomic_int released;
+static atomic_bool gate_open;
+static int owner_a;
+static int owner_b;
+
+static void job_count(ref_t data) {
+  (void)data;
+  atomic_fetch_add(&executed, 1);
+}
+
+static void job_wait_for_gate(ref_t data) {
+  (void)data;
+  while (!atomic_load(&gate_open)) {
+    time_sleep_ms(1);
+  }
+}
+
+static void data_destroy(ref_t data) {
+  (void)data;
+  atomic_fetch_add(&released, 1);
+}
+
+static void wait_for_executed(int expected) {
+  for (int i = 0; i < 1000 && atomic_load(&executed) < expected; i++) {
+    time_sleep_ms(1);
+  }
+}
+
+void setUp(void) {
+  err_o = (err_t){0};
+  atomic_store(&executed, 0);
+  atomic_store(&released, 0);
+  atomic_store(&gate_open, false);
+  TEST_ASSERT_NULL(worker_init(&worker, 1));
+}
+
+void tearDown(void) {
+  atomic_store(&gate_open, true);
+  worker_destroy(&worker);
+}
+
+void test_worker_runs_submitted_jobs_and_releases_data(void) {
+  for (int i = 0; i < 3; i++) {
+    ref_t data = mem_refalloc(sizeof(int), data_destroy);
+    worker_submit(worker, &owner_a, job_count, data);
+    mem_deref(data);
+  }
+
+  wait_for_executed(3);
+  worker_destroy(&worker);
+
+  TEST_ASSERT_EQUAL(3, atomic_load(&executed));
+  TEST_ASSERT_EQUAL(3, atomic_load(&released));
+}
+
+void test_worker_cancel_drops_only_jobs_of_owner(void) {
+  worker_submit(worker, &owner_b, job_wait_for_gate, NULL);
+
+  for (int i = 0; i < 2; i++) {
+    ref_t data = mem_refalloc(sizeof(int), data_destroy);
+    worker_submit(worker, &owner_a, job_count, data);
+    worker_submit(worker, &owner_b, job_count, NULL);
+    mem_deref(data);
+  }
+
+  worker_cancel(worker, &owner_a);
+  TEST_ASSERT_EQUAL(2, atomic_load(&released));
+
+  atomic_store(&gate_open, true);
+  wait_for_executed(2);
+  worker_destroy(&worker);
+
+  TEST_ASSERT_EQUAL(2, atomic_load(&executed));
+}
+
+void test_worker_with_threads_runs_jobs_in_parallel(void) {
+  worker_destroy(&worker);
+  TEST_ASSERT_NULL(worker_init(&worker, 2));
+
+  // Job waiting for the gate blocks one thread, the other one goes on.
+  worker_submit(worker, &owner_a, job_wait_for_gate, NULL);
+  worker_submit(worker, &owner_a, job_count, NULL);
+
+  wait_for_executed(1);
+  TEST_ASSERT_EQUAL(1, atomic_load(&executed));
+
+  atomic_store(&gate_open, true);
+  worker_destroy(&worker);
+}